@@ -5,24 +5,28 @@
 #include <cstddef>
 #include <cmath>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 #include <etf/distribution.hpp>
+#include <etf/standard_partitions.hpp>
 #include <etf/util.hpp>
 
-#include "tail_dist.hpp"
-
 
 // ETF-based central normal distribution.
-template<typename RealType, std::size_t W, std::size_t N>
+template<typename RealType, std::size_t W, std::size_t N,
+         typename Layout=etf::split_layout,
+         typename Storage=etf::heap_storage>
 class EtfNormalDistribution
-    : public etf::central_distribution<RealType, W, N, RealType (*)(RealType),
-                                       NormalTailDistribution<RealType, W>>
+    : public etf::central_distribution<
+          RealType, W, N, RealType (*)(RealType),
+          etf::normal_tail_distribution<RealType, W>, void, Layout, Storage>
 {
 private:
     using Parent =
         etf::central_distribution<RealType, W, N, RealType (*)(RealType),
-                                  NormalTailDistribution<RealType, W>>;
+                                  etf::normal_tail_distribution<RealType, W>,
+                                  void, Layout, Storage>;
 
 public:
     EtfNormalDistribution();
@@ -31,39 +35,51 @@ private:
     static RealType pdf(RealType x) {
         return std::exp(RealType(-0.5)*x*x);
     }
+
+#if __cplusplus >= 201703L
+    // Uses a partition computed at compile time.
+    void init(std::true_type) {
+        using Partition = etf::static_normal_partition<RealType, W, N>;
+        assign(Partition::partition, Partition::xtail, Partition::tail_area);
+    }
+#endif
+
+    // Computes the partition at run time.
+    void init(std::false_type);
+
+    template<typename Partition>
+    void assign(const Partition& p, RealType xtail, RealType tail_area) {
+        *static_cast<Parent*>(this) =
+            etf::make_central_distribution<RealType, W, N, Layout, Storage>(
+                p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(),
+                &pdf, etf::normal_tail_distribution<RealType, W>(xtail),
+                tail_area);
+    }
 };
 
 
-template<typename RealType, std::size_t W, std::size_t N>
-EtfNormalDistribution<RealType, W, N>::EtfNormalDistribution()
+template<typename RealType, std::size_t W, std::size_t N,
+         typename Layout, typename Storage>
+EtfNormalDistribution<RealType, W, N, Layout, Storage>::EtfNormalDistribution()
+{
+    // The tail is sampled with Marsaglia's algorithm.
+#if __cplusplus >= 201703L
+    // Small partitions are computed at compile time.
+    init(std::integral_constant<bool, N<=etf::static_partition_max_n>());
+#else
+    init(std::false_type());
+#endif
+}
+
+
+template<typename RealType, std::size_t W, std::size_t N,
+         typename Layout, typename Storage>
+void EtfNormalDistribution<RealType, W, N, Layout, Storage>::init(
+    std::false_type)
 {
     const std::size_t n = std::size_t(1) << N;
     
-    // The tail is sampled with Marsaglia's algorithm.
-    // For high precision (W large), the position of the tail can be chosen
-    // rather freely; for low W values, though, the tail position should be
-    // chosen such that the area of the tail relatively to the whole area
-    // sampled (upper rectangles + tail) is a multiple of 1/2^(W-N-1) so as
-    // to avoid excessive rounding errors on the sampling probability.
-    // Magical values that are closest to the empirical optimum of the tail
-    // position (around 3.25) are tabulated for the common cases N=7 and N=8.
-    RealType xtail;
-    if (N==7 && W>=11) {
-        RealType magic_xtail[] =
-            { 1.532095304, 1.859950459, 2.150455371, 2.413614185,
-              2.655703474, 2.880953316, 3.092363645, 3.292145211 };
-        xtail = magic_xtail[std::min(W - 11, N)];
-    }
-    else if (N==8 && W>=12) {
-        RealType magic_xtail[] =
-            { 1.533103263, 1.861331463, 2.152146391, 2.415553089,
-              2.657829951, 2.883210552, 3.094702254, 3.294526271 };
-        xtail = magic_xtail[std::min(W - 12, N)];
-    }
-    else {
-        // let's hope W is large...
-        xtail = 3.25;
-    }
+    const RealType xtail = etf::normal_xtail<RealType>(W, N);
     
     // Tail area.
     const RealType sqrt_pi_over_two = 1.2533141373155001;
@@ -83,11 +99,7 @@ EtfNormalDistribution<RealType, W, N>::EtfNormalDistribution()
         x_guess.begin(), x_guess.end(),
         rel_tol);
     
-    *static_cast<Parent*>(this) =
-        etf::make_central_distribution<RealType, W, N>(
-            p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(),
-            &pdf, NormalTailDistribution<RealType, W>(xtail), tail_area);
+    assign(p, xtail, tail_area);
 }
 
 #endif // ETF_LIB_NORMAL_HPP
-
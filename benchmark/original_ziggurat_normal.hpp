@@ -4,8 +4,7 @@
 #include <vector>
 
 #include <etf/random_digits.hpp>
-
-#include "tail_dist.hpp"
+#include <etf/util.hpp>
 
 
 namespace detail {
@@ -73,7 +72,7 @@ private:
     std::vector<RealType> w_;
     std::vector<IntType> k_;
     std::vector<RealType> f_;
-    NormalTailDistribution<
+    etf::normal_tail_distribution<
         RealType, std::numeric_limits<UIntType>::digits> tail_dist_;
 };
 
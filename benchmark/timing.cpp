@@ -8,6 +8,7 @@
 #include "original_ziggurat_normal.hpp"
 #include "ziggurat_normal.hpp"
 #include "etf_normal.hpp"
+#include <etf/xoshiro.hpp>
 
 #include "etf_chi_squared.hpp"
 #include "etf_chi_squared_low_dof.hpp"
@@ -45,9 +46,13 @@
 NONIUS_BENCHMARK("original ziggurat normal (32-bit)", DIST_SUM(std::mt19937, OriginalZigguratNormalDistribution32<double>()));
 NONIUS_BENCHMARK("ziggurat normal (32-bit)", DIST_SUM(std::mt19937, (ZigguratNormalDistribution<double, 32>())));
 NONIUS_BENCHMARK("ETF normal (32-bit)", DIST_SUM(std::mt19937, (EtfNormalDistribution<double, 32, 7>())));
+NONIUS_BENCHMARK("ETF normal (32-bit, 64-bit bit pool)", DIST_SUM(etf::bit_pool<std::mt19937_64>, (EtfNormalDistribution<double, 32, 7>())));
 
 NONIUS_BENCHMARK("original ziggurat (64-bit)", DIST_SUM(std::mt19937_64, OriginalZigguratNormalDistribution64<double>()));
 NONIUS_BENCHMARK("ziggurat normal (64-bit)", DIST_SUM(std::mt19937_64, (ZigguratNormalDistribution<double, 64>())));
 NONIUS_BENCHMARK("ETF normal (64-bit)", DIST_SUM(std::mt19937_64, (EtfNormalDistribution<double, 64, 7>())));
+NONIUS_BENCHMARK("ETF normal (64-bit, packed layout)", DIST_SUM(std::mt19937_64, (EtfNormalDistribution<double, 64, 7, etf::packed_layout>())));
+NONIUS_BENCHMARK("ETF normal (64-bit, inline storage)", DIST_SUM(std::mt19937_64, (EtfNormalDistribution<double, 64, 7, etf::split_layout, etf::inline_storage>())));
+NONIUS_BENCHMARK("ETF normal (64-bit, xoshiro256++)", DIST_SUM(etf::xoshiro256pp, (EtfNormalDistribution<double, 64, 7>())));
 NONIUS_BENCHMARK("standard library normal (64-bit)", DIST_SUM(std::mt19937_64, std::normal_distribution<double>()));
 
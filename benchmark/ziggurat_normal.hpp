@@ -6,8 +6,7 @@
 #include <vector>
 
 #include <etf/random_digits.hpp>
-
-#include "tail_dist.hpp"
+#include <etf/util.hpp>
 
 
 
@@ -101,7 +100,7 @@ private:
     std::vector<RealType> w_;
     std::vector<IntType> k_;
     std::vector<RealType> f_;
-    NormalTailDistribution<RealType, W> tail_dist_;
+    etf::normal_tail_distribution<RealType, W> tail_dist_;
 };
 
 
@@ -0,0 +1,282 @@
+#ifndef ETF_DERIVATIVE_HPP
+#define ETF_DERIVATIVE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Dual number for forward-mode automatic differentiation.
+///
+/// A dual number holds a value and its derivative with respect to some
+/// variable. Arithmetic operators and common mathematical functions propagate
+/// the derivative exactly using the chain rule. Mathematical functions are
+/// found by argument-dependent lookup, so generic code should call them
+/// unqualified after a using-declaration, e.g. `using std::exp; exp(x)`.
+///
+/// Comparison operators only compare the values.
+///
+template<typename RealType>
+class dual
+{
+public:
+    using value_type = RealType;
+
+    constexpr dual(RealType value = RealType(0),
+                   RealType derivative = RealType(0))
+    : v_(value), d_(derivative) {}
+
+    /// Returns the value.
+    ///
+    constexpr RealType value() const { return v_; }
+
+    /// Returns the derivative.
+    ///
+    constexpr RealType derivative() const { return d_; }
+
+    dual& operator+=(const dual& b) { return *this = *this + b; }
+    dual& operator-=(const dual& b) { return *this = *this - b; }
+    dual& operator*=(const dual& b) { return *this = *this*b; }
+    dual& operator/=(const dual& b) { return *this = *this/b; }
+
+    // Arithmetic operators.
+    friend dual operator+(const dual& a) {
+        return a;
+    }
+
+    friend dual operator-(const dual& a) {
+        return dual(-a.v_, -a.d_);
+    }
+
+    friend dual operator+(const dual& a, const dual& b) {
+        return dual(a.v_ + b.v_, a.d_ + b.d_);
+    }
+
+    friend dual operator-(const dual& a, const dual& b) {
+        return dual(a.v_ - b.v_, a.d_ - b.d_);
+    }
+
+    friend dual operator*(const dual& a, const dual& b) {
+        return dual(a.v_*b.v_, a.d_*b.v_ + a.v_*b.d_);
+    }
+
+    friend dual operator/(const dual& a, const dual& b) {
+        RealType q = a.v_/b.v_;
+        return dual(q, (a.d_ - q*b.d_)/b.v_);
+    }
+
+    // Comparison operators.
+    friend bool operator==(const dual& a, const dual& b) {
+        return a.v_==b.v_;
+    }
+
+    friend bool operator!=(const dual& a, const dual& b) {
+        return a.v_!=b.v_;
+    }
+
+    friend bool operator<(const dual& a, const dual& b) {
+        return a.v_<b.v_;
+    }
+
+    friend bool operator>(const dual& a, const dual& b) {
+        return a.v_>b.v_;
+    }
+
+    friend bool operator<=(const dual& a, const dual& b) {
+        return a.v_<=b.v_;
+    }
+
+    friend bool operator>=(const dual& a, const dual& b) {
+        return a.v_>=b.v_;
+    }
+
+    // Mathematical functions.
+    friend dual abs(const dual& a) {
+        return a.v_<RealType(0) ? -a : a;
+    }
+
+    friend dual fabs(const dual& a) {
+        return abs(a);
+    }
+
+    friend dual exp(const dual& a) {
+        using std::exp;
+        RealType e = exp(a.v_);
+        return dual(e, e*a.d_);
+    }
+
+    friend dual expm1(const dual& a) {
+        using std::exp;
+        using std::expm1;
+        return dual(expm1(a.v_), exp(a.v_)*a.d_);
+    }
+
+    friend dual log(const dual& a) {
+        using std::log;
+        return dual(log(a.v_), a.d_/a.v_);
+    }
+
+    friend dual log1p(const dual& a) {
+        using std::log1p;
+        return dual(log1p(a.v_), a.d_/(RealType(1) + a.v_));
+    }
+
+    friend dual sqrt(const dual& a) {
+        using std::sqrt;
+        RealType s = sqrt(a.v_);
+        return dual(s, a.d_/(RealType(2)*s));
+    }
+
+    friend dual cbrt(const dual& a) {
+        using std::cbrt;
+        RealType c = cbrt(a.v_);
+        return dual(c, a.d_/(RealType(3)*c*c));
+    }
+
+    friend dual pow(const dual& a, const dual& b) {
+        using std::log;
+        using std::pow;
+        RealType p = pow(a.v_, b.v_);
+        // Avoid evaluating the logarithm for a constant exponent, which
+        // would produce NaNs for non-positive bases.
+        RealType d = a.d_==RealType(0) ? RealType(0)
+                                       : b.v_*pow(a.v_, b.v_ - 1)*a.d_;
+        if (b.d_!=RealType(0))
+            d += p*log(a.v_)*b.d_;
+        return dual(p, d);
+    }
+
+    friend dual sin(const dual& a) {
+        using std::sin;
+        using std::cos;
+        return dual(sin(a.v_), cos(a.v_)*a.d_);
+    }
+
+    friend dual cos(const dual& a) {
+        using std::sin;
+        using std::cos;
+        return dual(cos(a.v_), -sin(a.v_)*a.d_);
+    }
+
+    friend dual tan(const dual& a) {
+        using std::tan;
+        RealType t = tan(a.v_);
+        return dual(t, (RealType(1) + t*t)*a.d_);
+    }
+
+    friend dual atan(const dual& a) {
+        using std::atan;
+        return dual(atan(a.v_), a.d_/(RealType(1) + a.v_*a.v_));
+    }
+
+    friend dual sinh(const dual& a) {
+        using std::sinh;
+        using std::cosh;
+        return dual(sinh(a.v_), cosh(a.v_)*a.d_);
+    }
+
+    friend dual cosh(const dual& a) {
+        using std::sinh;
+        using std::cosh;
+        return dual(cosh(a.v_), sinh(a.v_)*a.d_);
+    }
+
+    friend dual tanh(const dual& a) {
+        using std::tanh;
+        RealType t = tanh(a.v_);
+        return dual(t, (RealType(1) - t*t)*a.d_);
+    }
+
+    friend dual erf(const dual& a) {
+        using std::erf;
+        using std::exp;
+        const RealType two_over_sqrt_pi =
+            RealType(1.128379167095512573896158903121545172L);
+        return dual(erf(a.v_), two_over_sqrt_pi*exp(-a.v_*a.v_)*a.d_);
+    }
+
+    friend dual erfc(const dual& a) {
+        using std::erfc;
+        using std::exp;
+        const RealType two_over_sqrt_pi =
+            RealType(1.128379167095512573896158903121545172L);
+        return dual(erfc(a.v_), -two_over_sqrt_pi*exp(-a.v_*a.v_)*a.d_);
+    }
+
+private:
+    RealType v_;
+    RealType d_;
+};
+
+
+/// Derivative placeholder requesting forward-mode automatic differentiation.
+///
+/// When passed in place of the derivative to the partition solvers, the
+/// function and its derivative are computed together by a single evaluation
+/// of the function with a `dual<RealType>` argument. The function must
+/// therefore be callable with both a `RealType` and a `dual<RealType>`
+/// argument, typically as a function template or a generic lambda.
+///
+struct automatic_derivative {};
+
+
+/// Derivative placeholder requesting a finite difference approximation.
+///
+/// When passed in place of the derivative to the partition solvers, the
+/// derivative at each node `x` is approximated by a forward difference with a
+/// step `rel_step*|x|`, or `rel_step` if `x` is 0, at the cost of one extra
+/// function evaluation per node. The default relative step is the square root
+/// of the machine epsilon, which roughly balances truncation and rounding
+/// errors.
+///
+template<typename RealType>
+struct finite_difference_derivative
+{
+    explicit finite_difference_derivative(
+        RealType rel_step =
+            std::sqrt(std::numeric_limits<RealType>::epsilon()))
+    : rel_step(rel_step) {}
+
+    RealType rel_step;
+};
+
+
+namespace detail {
+
+// Evaluates a function and its derivative at a node.
+template<class Func, class DFunc, typename RealType>
+void evaluate_node(Func& f, DFunc& df,
+                   RealType x, RealType& y, RealType& dy) {
+    y = f(x);
+    dy = df(x);
+}
+
+template<class Func, typename RealType>
+void evaluate_node(Func& f, automatic_derivative&,
+                   RealType x, RealType& y, RealType& dy) {
+    dual<RealType> r = f(dual<RealType>(x, RealType(1)));
+    y = r.value();
+    dy = r.derivative();
+}
+
+template<class Func, typename RealType>
+void evaluate_node(Func& f, finite_difference_derivative<RealType>& df,
+                   RealType x, RealType& y, RealType& dy) {
+    using std::abs;
+    y = f(x);
+    RealType h = df.rel_step*(x!=RealType(0) ? abs(x) : RealType(1));
+    // Use the step actually represented after rounding of `x + h`.
+    RealType xh = x + h;
+    h = xh - x;
+    dy = (f(xh) - y)/h;
+}
+
+} // namespace detail
+
+} // namespace etf
+
+#endif // ETF_DERIVATIVE_HPP
@@ -0,0 +1,495 @@
+#ifndef ETF_DISCRETE_HPP
+#define ETF_DISCRETE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "implementation.hpp"
+#include "random_digits.hpp"
+#include "statistics.hpp"
+#include "table.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+template<typename IntType>
+class discrete_bounded
+{
+public:
+    using result_type = IntType;
+
+public:
+    template<typename=void>
+    void reset() {}
+
+protected:
+    discrete_bounded() = default;
+
+    template<class RngType>
+    IntType sample_outer(RngType&) const {
+        return IntType(0); // never called
+    }
+
+    template<typename=void>
+    IntType outer_min() const { return IntType(0); } // never called
+
+    template<typename=void>
+    IntType outer_max() const { return IntType(0); } // never called
+
+protected:
+    static constexpr bool HasOuter = false;
+};
+
+
+template<typename IntType, typename OuterDist>
+class discrete_composite : public discrete_bounded<IntType>
+{
+public:
+    template<typename=void>
+    void reset() {
+        outer_dist_.reset();
+    }
+
+protected:
+    discrete_composite() = default;
+
+    discrete_composite(OuterDist outer_dist) : outer_dist_(outer_dist) {}
+
+    template<class RngType>
+    IntType sample_outer(RngType& g) {
+        return static_cast<IntType>(outer_dist_(g));
+    }
+
+    template<class RngType>
+    IntType sample_outer(RngType& g) const {
+        return static_cast<IntType>(outer_dist_(g));
+    }
+
+    template<typename=void>
+    IntType outer_min() const {
+        return static_cast<IntType>(outer_dist_.min());
+    }
+
+    template<typename=void>
+    IntType outer_max() const {
+        return static_cast<IntType>(outer_dist_.max());
+    }
+
+protected:
+    OuterDist outer_dist_;
+    static constexpr bool HasOuter = true;
+};
+
+
+// Discrete ETF sampler.
+//
+// The probability mass of the values k0, ..., k0+n-1 is split into 2^N slots
+// of equal probability, each made of `outer_switch` consecutive positions.
+// Position `c` maps to the value of index j such that
+//
+//     cumulative[j-1] <= c < cumulative[j]
+//
+// where `cumulative[j]` is the number of positions mapped to the values of
+// index 0 to j. Each slot stores the value of its first position and the
+// number of following positions mapped to the same value: most samples are
+// therefore resolved with a single comparison, and the other ones with a
+// search restricted to the values covered by the slot.
+template<typename IntType, std::size_t W, std::size_t N, class Category,
+         class Storage, class Statistics>
+class discrete : public Category, public statistics_recorder<Statistics>
+{
+private:
+    static_assert(std::is_integral<IntType>::value,
+                  "the result type must be an integer type");
+    static_assert(N<W, "the table index must be narrower than W");
+
+protected:
+    using UIntType = typename etf::integer_traits<W>::uint_least_t;
+    using UIntK = typename std::make_unsigned<IntType>::type;
+
+    struct entry
+    {
+        UIntType threshold;
+        IntType value;
+    };
+
+    static constexpr std::size_t size = std::size_t(1) << N;
+
+public:
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    IntType operator()(RngType& g) {
+        return sample(*this, g);
+    }
+
+    /// Returns a random number without modifying the distribution.
+    ///
+    /// This overload requires the `no_statistics` policy and an outer
+    /// distribution callable on const objects.
+    ///
+    template<class RngType>
+    IntType operator()(RngType& g) const {
+        return sample(*this, g);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) {
+        generate_range(*this, first, last, g);
+    }
+
+    /// Fills a range with random numbers without modifying the distribution.
+    ///
+    /// This overload has the same requirements as the const `operator()`.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        generate_range(*this, first, last, g);
+    }
+
+    template<typename=void>
+    IntType min() const {
+        return Category::HasOuter ? std::min(k_first_, this->outer_min())
+                                  : k_first_;
+    }
+
+    template<typename=void>
+    IntType max() const {
+        return Category::HasOuter ? std::max(k_last_, this->outer_max())
+                                  : k_last_;
+    }
+
+    /// Returns the size in bytes of the slot table.
+    ///
+    /// Only the slot table is accessed on the fast path; the cumulative
+    /// table, whose size depends on the number of values, is only accessed
+    /// for samples from slots covering several values.
+    ///
+    static constexpr std::size_t table_footprint() {
+        return size*sizeof(entry);
+    }
+
+    /// Returns true if copies of the distribution share its lookup tables.
+    ///
+    static constexpr bool shares_tables() {
+        return std::is_same<Storage, shared_storage>::value;
+    }
+
+protected:
+    using Category::Category;
+
+    template<class InputIt>
+    void build(IntType k_first, InputIt p_first, InputIt p_last,
+               double outer_area);
+
+    // Generates a number.
+    template<class Self, class RngType>
+    static IntType sample(Self& self, RngType& g) {
+        auto&& h = self.engine(g);
+        self.record_samples(1);
+        auto r = generate_random_integer<UIntType, W>(h);
+        IntType k;
+        if (self.sample_fast(r, k)) {
+            self.record_fast(1);
+            return k;
+        }
+        return sample_slow(self, h, r);
+    }
+
+    // Fills a range with numbers generated block-wise.
+    template<class Self, class ForwardIt, class RngType>
+    static void generate_range(Self& self, ForwardIt first, ForwardIt last,
+                               RngType& g) {
+        auto&& h = self.engine(g);
+        using Engine = typename std::remove_reference<decltype(h)>::type;
+        detail::generate_blocks<IntType, UIntType, W>(first, last, h,
+            [&self](const UIntType* r, IntType* k, std::size_t m,
+                    unsigned short* miss) {
+                std::size_t nb_miss = self.sample_fast_block(r, k, m, miss);
+                self.record_samples(m);
+                self.record_fast(m - nb_miss);
+                return nb_miss;
+            },
+            [&self](Engine& e, UIntType r) {
+                return sample_slow(self, e, r);
+            });
+    }
+
+    // Attempts to generate a number from the random integer using the fast
+    // path only.
+    //
+    // The candidate value is loaded unconditionally and is only valid if
+    // true is returned.
+    bool sample_fast(UIntType r, IntType& k) const {
+        // Position within the slot is made of bits 0:(W-N-1).
+        constexpr UIntType m_mask = (UIntType(1) << (W - N)) - 1;
+        UIntType u = r & m_mask;
+        // The slot index is made of bits (W-N):(W-1).
+        auto i = std::size_t(r >> (W - N));
+
+        const auto& d = table_[i];
+        k = d.value;
+        // Note that the following test will also fail if 'u' is greater or
+        // equal to the outer switch value since no threshold is greater than
+        // the switch value.
+        return u<d.threshold;
+    }
+
+    // Attempts the fast path on a block of random integers.
+    //
+    // The indices of the random integers which missed the fast path are
+    // written to `miss` and their number is returned.
+    std::size_t sample_fast_block(const UIntType* r, IntType* k,
+                                  std::size_t m, unsigned short* miss) const {
+        std::size_t nb_miss = 0;
+        for (std::size_t j=0; j!=m; ++j) {
+            bool hit = sample_fast(r[j], k[j]);
+            miss[nb_miss] = static_cast<unsigned short>(j);
+            nb_miss += hit ? 0 : 1;
+        }
+        return nb_miss;
+    }
+
+    // Generates a number from a random integer that missed the fast path.
+    template<class Self, class RngType>
+    static IntType sample_slow(Self& self, RngType& g, UIntType r) {
+        constexpr UIntType m_mask = (UIntType(1) << (W - N)) - 1;
+        UIntType u = r & m_mask;
+        auto i = std::size_t(r >> (W - N));
+
+        // Should the outer distribution be sampled?
+        if (Category::HasOuter && u>=self.outer_switch_) {
+            IntType k = self.sample_outer(g);
+            self.record_outer(true);
+            return k;
+        }
+
+        // Otherwise the position lies past the first value of the slot:
+        // search the cumulative table between the next value and the first
+        // value of the next slot.
+        UIntType c = UIntType(i)*self.outer_switch_ + u;
+        std::size_t j = self.index(self.table_[i].value) + 1;
+        std::size_t j_end = i + 1!=size ? self.index(self.table_[i+1].value)
+                                        : self.nb_values_ - 1;
+        const UIntType* cumulative = self.cumulative_.data();
+        j = static_cast<std::size_t>(
+            std::upper_bound(cumulative + j, cumulative + j_end, c) -
+            cumulative);
+        self.record_wedge(true);
+        return self.value(j);
+    }
+
+    // Conversions between values and value indices, computed with unsigned
+    // arithmetic to avoid overflows. Results are converted back to `UIntK`
+    // since types narrower than `int` are promoted to `int`.
+    IntType value(std::size_t j) const {
+        return static_cast<IntType>(static_cast<UIntK>(
+            static_cast<UIntK>(k_first_) + static_cast<UIntK>(j)));
+    }
+
+    std::size_t index(IntType k) const {
+        return static_cast<std::size_t>(static_cast<UIntK>(
+            static_cast<UIntK>(k) - static_cast<UIntK>(k_first_)));
+    }
+
+protected:
+    typename Storage::template array<entry, size> table_;
+    typename runtime_array<Storage, UIntType>::type cumulative_;
+    std::size_t nb_values_;
+    IntType k_first_;
+    IntType k_last_;
+    UIntType outer_switch_;
+};
+
+
+template<typename IntType, std::size_t W, std::size_t N, class Category,
+         class Storage, class Statistics>
+template<class InputIt>
+void discrete<IntType, W, N, Category, Storage, Statistics>::build(
+    IntType k_first, InputIt p_first, InputIt p_last, double outer_area) {
+    // Copy the probabilities and trim leading and trailing zeros.
+    std::vector<double> p(p_first, p_last);
+    long double total = 0.0L;
+    for (double pk : p) {
+        if (!(pk>=0.0) || !std::isfinite(pk))
+            throw std::invalid_argument("invalid discrete probability");
+        total += pk;
+    }
+    if (!(total>0.0L))
+        throw std::invalid_argument("discrete probabilities sum to 0");
+    if (!(outer_area>=0.0) || !std::isfinite(outer_area))
+        throw std::invalid_argument("invalid outer probability");
+
+    std::size_t first = 0;
+    while (p[first]==0.0)
+        ++first;
+    std::size_t last = p.size();
+    while (p[last - 1]==0.0)
+        --last;
+    nb_values_ = last - first;
+    const UIntK k_span = static_cast<UIntK>(
+        static_cast<UIntK>(std::numeric_limits<IntType>::max()) -
+        static_cast<UIntK>(k_first));
+    if (last - 1>k_span)
+        throw std::invalid_argument("discrete values out of range");
+    k_first_ = k_first;
+    k_first_ = value(first);
+    k_last_ = value(nb_values_ - 1);
+
+    // Compute the outer switch, i.e. the number of positions per slot, such
+    // that when drawing a random integer r, the probability:
+    //  P(r>=switch)
+    // expresses the probability to sample the outer distribution.
+    constexpr UIntType m_range = UIntType(1) << (W - N);
+    outer_switch_ = m_range;
+    if (Category::HasOuter) {
+        outer_switch_ = static_cast<UIntType>(std::round(
+            static_cast<long double>(m_range)*(total/(total + outer_area))));
+        if (outer_switch_==0)
+            throw std::invalid_argument("discrete probabilities too small");
+    }
+
+    // Compute the number of positions mapped to each value and all preceding
+    // ones. The last value, which is mapped to all remaining positions, is
+    // omitted.
+    const UIntType last_position = UIntType(size - 1)*outer_switch_ +
+                                   (outer_switch_ - 1);
+    const long double scale =
+        static_cast<long double>(size)*static_cast<long double>(outer_switch_);
+    resize_array(cumulative_, nb_values_ - 1);
+    long double sum = 0.0L;
+    for (std::size_t j=0; j + 1<nb_values_; ++j) {
+        sum += p[first + j];
+        long double c = std::round(sum/total*scale);
+        cumulative_[j] = c<static_cast<long double>(last_position)
+                         ? static_cast<UIntType>(c) : last_position;
+    }
+
+    // Compute the slots.
+    resize_array(table_, size);
+    std::size_t j = 0;
+    for (std::size_t i=0; i!=size; ++i) {
+        UIntType start = UIntType(i)*outer_switch_;
+        while (j + 1<nb_values_ && cumulative_[j]<=start)
+            ++j;
+        auto& d = table_[i];
+        d.value = value(j);
+        d.threshold = j + 1<nb_values_
+                      ? std::min(UIntType(cumulative_[j] - start),
+                                 outer_switch_)
+                      : outer_switch_;
+    }
+}
+
+} // namespace detail
+
+
+/// Discrete ETF distribution with a user-provided tail distribution.
+///
+/// The distribution generates the integer values k0, k0+1, ... with
+/// probabilities proportional to the provided weights and, with a probability
+/// proportional to the outer area, values generated by the outer
+/// distribution.
+///
+template<typename IntType, std::size_t W, std::size_t N,
+         typename OuterDist=void, typename Storage=heap_storage,
+         typename Statistics=no_statistics>
+class discrete_distribution : public
+    detail::discrete<IntType, W, N,
+        detail::discrete_composite<IntType, OuterDist>, Storage, Statistics>
+{
+private:
+    using Parent =
+        detail::discrete<IntType, W, N,
+            detail::discrete_composite<IntType, OuterDist>,
+            Storage, Statistics>;
+
+public:
+    discrete_distribution() = default;
+
+    template<typename InputIt>
+    discrete_distribution(IntType k_first, InputIt p_first, InputIt p_last,
+                          OuterDist outer_dist, double outer_area)
+    : Parent(outer_dist) {
+        this->build(k_first, p_first, p_last, outer_area);
+    }
+
+private:
+    using Parent::build;
+};
+
+
+/// Discrete ETF distribution over a bounded range.
+///
+template<typename IntType, std::size_t W, std::size_t N,
+         typename Storage, typename Statistics>
+class discrete_distribution<IntType, W, N, void, Storage, Statistics>
+: public detail::discrete<IntType, W, N, detail::discrete_bounded<IntType>,
+                          Storage, Statistics>
+{
+private:
+    using Parent =
+        detail::discrete<IntType, W, N, detail::discrete_bounded<IntType>,
+                         Storage, Statistics>;
+
+public:
+    discrete_distribution() = default;
+
+    template<typename InputIt>
+    discrete_distribution(IntType k_first, InputIt p_first, InputIt p_last) {
+        this->build(k_first, p_first, p_last, 0.0);
+    }
+
+private:
+    using Parent::build;
+};
+
+
+/// Create a discrete distribution object with a user-provided tail
+/// distribution, deducing trailing types.
+///
+template<typename IntType, std::size_t W, std::size_t N, // explicit
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
+         typename InputIt, typename OuterDist> // implicit
+inline
+auto make_discrete_distribution(IntType k_first,
+                                InputIt p_first, InputIt p_last,
+                                OuterDist outer_dist, double outer_area)
+-> etf::discrete_distribution<IntType, W, N, OuterDist, Storage,
+                              Statistics> {
+    return etf::discrete_distribution<IntType, W, N, OuterDist, Storage,
+                                      Statistics>(
+        k_first, p_first, p_last, outer_dist, outer_area);
+}
+
+
+/// Create a discrete distribution object over a bounded range, deducing
+/// trailing types.
+///
+template<typename IntType, std::size_t W, std::size_t N, // explicit
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
+         typename InputIt> // implicit
+inline
+auto make_discrete_distribution(IntType k_first,
+                                InputIt p_first, InputIt p_last)
+-> etf::discrete_distribution<IntType, W, N, void, Storage, Statistics> {
+    return etf::discrete_distribution<IntType, W, N, void, Storage,
+                                      Statistics>(k_first, p_first, p_last);
+}
+
+} // namespace etf
+
+#endif // ETF_DISCRETE_HPP
@@ -0,0 +1,446 @@
+#ifndef ETF_DISPATCH_HPP
+#define ETF_DISPATCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#endif
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Data cache sizes, in bytes.
+///
+struct cache_sizes
+{
+    std::size_t l1d; ///< level 1 data cache
+    std::size_t l2;  ///< level 2 cache
+};
+
+
+/// Returns the data cache sizes of the processor.
+///
+/// The sizes are queried with `sysconf` where supported; otherwise, or if the
+/// query fails, typical sizes of 32 KiB and 256 KiB are returned.
+///
+inline cache_sizes query_cache_sizes() {
+    cache_sizes caches = { 32*1024, 256*1024 };
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    long l1d = ::sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    long l2 = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l1d>0)
+        caches.l1d = static_cast<std::size_t>(l1d);
+    if (l2>0)
+        caches.l2 = static_cast<std::size_t>(l2);
+#endif
+    return caches;
+}
+
+
+namespace detail {
+
+inline std::atomic<std::size_t>& table_registry() {
+    static std::atomic<std::size_t> footprint(0);
+    return footprint;
+}
+
+} // namespace detail
+
+
+/// Registers lookup tables that the process keeps hot.
+///
+/// The registered footprint is taken into account when a
+/// `dispatched_distribution` selects its table size. Dispatched distributions
+/// register their own tables; this function makes it possible to account for
+/// other tables, e.g. with `register_tables(d.table_footprint())` for some
+/// distribution `d`.
+///
+inline void register_tables(std::size_t footprint) {
+    detail::table_registry() += footprint;
+}
+
+
+/// Unregisters lookup tables formerly registered with `register_tables`.
+///
+inline void unregister_tables(std::size_t footprint) {
+    detail::table_registry() -= footprint;
+}
+
+
+/// Returns the total size in bytes of the registered lookup tables.
+///
+inline std::size_t registered_tables() {
+    return detail::table_registry();
+}
+
+
+/// Selects a table size among candidates.
+///
+/// Given the footprints in bytes of the candidate tables sorted by increasing
+/// size and the footprint of the other tables kept hot, returns the index of
+/// the largest candidate such that all tables fit in the L1 data cache or,
+/// failing that, in the L2 cache, or the index of the smallest candidate if
+/// none fits in the L2 cache.
+///
+inline std::size_t select_table_size(const std::size_t* footprints,
+                                     std::size_t nb_candidates,
+                                     std::size_t other_footprint,
+                                     const cache_sizes& caches) {
+    const std::size_t levels[2] = { caches.l1d, caches.l2 };
+    for (std::size_t level : levels) {
+        for (std::size_t i=nb_candidates; i!=0; --i) {
+            if (other_footprint + footprints[i - 1]<=level)
+                return i - 1;
+        }
+    }
+    return 0;
+}
+
+
+namespace detail {
+
+// Calls a function object with the alternative of a dispatched distribution
+// designated by a run-time index.
+template<template<std::size_t> class Dist, std::size_t I,
+         std::size_t... Ns>
+struct table_size_dispatch;
+
+template<template<std::size_t> class Dist, std::size_t I, std::size_t N>
+struct table_size_dispatch<Dist, I, N>
+{
+    template<class F>
+    static auto apply(std::size_t, void* p, F& f)
+    -> decltype(f(*static_cast<Dist<N>*>(p))) {
+        return f(*static_cast<Dist<N>*>(p));
+    }
+
+    template<class Factory>
+    static void construct(std::size_t, void* p, Factory& make) {
+        ::new (p) Dist<N>(make(std::integral_constant<std::size_t, N>()));
+    }
+};
+
+template<template<std::size_t> class Dist, std::size_t I,
+         std::size_t N, std::size_t M, std::size_t... Ns>
+struct table_size_dispatch<Dist, I, N, M, Ns...>
+{
+    using next = table_size_dispatch<Dist, I + 1, M, Ns...>;
+
+    template<class F>
+    static auto apply(std::size_t i, void* p, F& f)
+    -> decltype(f(*static_cast<Dist<N>*>(p))) {
+        return i==I ? f(*static_cast<Dist<N>*>(p)) : next::apply(i, p, f);
+    }
+
+    template<class Factory>
+    static void construct(std::size_t i, void* p, Factory& make) {
+        if (i==I)
+            ::new (p) Dist<N>(make(std::integral_constant<std::size_t, N>()));
+        else
+            next::construct(i, p, make);
+    }
+};
+
+
+struct dispatch_copy
+{
+    void* dst;
+
+    template<class T>
+    void operator()(T& src) const { ::new (dst) T(src); }
+};
+
+struct dispatch_move
+{
+    void* dst;
+
+    template<class T>
+    void operator()(T& src) const { ::new (dst) T(std::move(src)); }
+};
+
+struct dispatch_destroy
+{
+    template<class T>
+    void operator()(T& d) const { d.~T(); }
+};
+
+template<typename RealType, class RngType>
+struct dispatch_sample
+{
+    RngType& g;
+
+    template<class T>
+    RealType operator()(T& d) const { return d(g); }
+};
+
+template<typename RealType, class RngType>
+struct dispatch_const_sample
+{
+    RngType& g;
+
+    template<class T>
+    RealType operator()(const T& d) const { return d(g); }
+};
+
+template<class ForwardIt, class RngType>
+struct dispatch_generate
+{
+    ForwardIt first;
+    ForwardIt last;
+    RngType& g;
+
+    template<class T>
+    void operator()(T& d) const { d.generate(first, last, g); }
+};
+
+template<class ForwardIt, class RngType>
+struct dispatch_const_generate
+{
+    ForwardIt first;
+    ForwardIt last;
+    RngType& g;
+
+    template<class T>
+    void operator()(const T& d) const { d.generate(first, last, g); }
+};
+
+template<typename RealType>
+struct dispatch_min
+{
+    template<class T>
+    RealType operator()(const T& d) const { return d.min(); }
+};
+
+template<typename RealType>
+struct dispatch_max
+{
+    template<class T>
+    RealType operator()(const T& d) const { return d.max(); }
+};
+
+struct dispatch_reset
+{
+    template<class T>
+    void operator()(T& d) const { d.reset(); }
+};
+
+} // namespace detail
+
+
+/// Distribution with a table size selected at run time.
+///
+/// The distribution holds one of the distributions `Dist<N>` for the table
+/// index digits `Ns...`, which must be sorted by increasing value. The
+/// alternative is selected once at construction using the cache sizes of the
+/// processor and the footprint of the tables registered in the process (see
+/// `select_table_size`), and is then constructed with
+/// `make(std::integral_constant<std::size_t, N>())`.
+///
+/// Sampling does not involve any virtual call: the selected alternative is
+/// resolved by a perfectly predictable branch on each call or, with `visit`,
+/// once for an arbitrary sequence of operations.
+///
+/// The tables of the distribution are registered during its lifetime.
+/// Copies of a distribution whose alternatives share their tables between
+/// copies (`shared_storage`) share its registration, which ends with the last
+/// of them; a moved-to distribution takes over the registration of the
+/// moved-from one.
+///
+template<template<std::size_t> class Dist, std::size_t... Ns>
+class dispatched_distribution
+{
+private:
+    static_assert(sizeof...(Ns)!=0, "at least one value of N is required");
+
+    using dispatch = detail::table_size_dispatch<Dist, 0, Ns...>;
+
+public:
+    using result_type = typename std::tuple_element<0,
+        std::tuple<Dist<Ns>...>>::type::result_type;
+
+    /// Constructs the distribution with the table size most appropriate for
+    /// the current process.
+    ///
+    template<class Factory>
+    explicit dispatched_distribution(Factory make)
+    : dispatched_distribution(make, registered_tables(),
+                              query_cache_sizes()) {}
+
+    /// Constructs the distribution with the table size most appropriate for
+    /// the specified footprint of other hot tables and cache sizes.
+    ///
+    template<class Factory>
+    dispatched_distribution(Factory make, std::size_t other_footprint,
+                            const cache_sizes& caches)
+    : index_(select_table_size(footprints(), sizeof...(Ns),
+                               other_footprint, caches)) {
+        dispatch::construct(index_, &storage_, make);
+        registration_ = register_own_tables();
+    }
+
+    dispatched_distribution(const dispatched_distribution& other)
+    : index_(other.index_) {
+        detail::dispatch_copy f = { &storage_ };
+        other.apply(f);
+        registration_ = shared_tables()[index_] ? other.registration_
+                                                : register_own_tables();
+    }
+
+    dispatched_distribution(dispatched_distribution&& other)
+    : index_(other.index_), registration_(std::move(other.registration_)) {
+        detail::dispatch_move f = { &storage_ };
+        other.apply(f);
+    }
+
+    dispatched_distribution& operator=(const dispatched_distribution& other) {
+        if (this!=&other) {
+            dispatched_distribution tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    dispatched_distribution& operator=(dispatched_distribution&& other) {
+        if (this!=&other) {
+            destroy();
+            index_ = other.index_;
+            detail::dispatch_move f = { &storage_ };
+            other.apply(f);
+            registration_ = std::move(other.registration_);
+        }
+        return *this;
+    }
+
+    ~dispatched_distribution() {
+        destroy();
+    }
+
+    /// Returns the selected number of digits of the table index.
+    ///
+    std::size_t n() const {
+        static constexpr std::size_t n_values[] = { Ns... };
+        return n_values[index_];
+    }
+
+    /// Returns the size in bytes of the lookup tables.
+    ///
+    std::size_t table_footprint() const {
+        return footprints()[index_];
+    }
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) {
+        detail::dispatch_sample<result_type, RngType> f = { g };
+        return apply(f);
+    }
+
+    /// Returns a random number without modifying the distribution.
+    ///
+    /// This overload requires the const `operator()` of the alternatives.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        detail::dispatch_const_sample<result_type, RngType> f = { g };
+        return apply(f);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) {
+        detail::dispatch_generate<ForwardIt, RngType> f = { first, last, g };
+        apply(f);
+    }
+
+    /// Fills a range with random numbers without modifying the distribution.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        detail::dispatch_const_generate<ForwardIt, RngType> f = {
+            first, last, g };
+        apply(f);
+    }
+
+    template<typename=void>
+    result_type min() const {
+        detail::dispatch_min<result_type> f;
+        return apply(f);
+    }
+
+    template<typename=void>
+    result_type max() const {
+        detail::dispatch_max<result_type> f;
+        return apply(f);
+    }
+
+    template<typename=void>
+    void reset() {
+        detail::dispatch_reset f;
+        apply(f);
+    }
+
+    /// Calls `f(d)` with the selected distribution `d` of type `Dist<N>&`.
+    ///
+    /// The visitor must return the same type for all alternatives.
+    ///
+    template<class Visitor>
+    auto visit(Visitor&& f)
+    -> decltype(dispatch::apply(0, nullptr, f)) {
+        return apply(f);
+    }
+
+private:
+    static const std::size_t* footprints() {
+        static constexpr std::size_t values[] = {
+            Dist<Ns>::table_footprint()... };
+        return values;
+    }
+
+    static const bool* shared_tables() {
+        static constexpr bool values[] = { Dist<Ns>::shares_tables()... };
+        return values;
+    }
+
+    // Registers the tables and returns a token which unregisters them when
+    // the last object sharing it is destroyed.
+    std::shared_ptr<void> register_own_tables() const {
+        const std::size_t footprint = table_footprint();
+        register_tables(footprint);
+        return std::shared_ptr<void>(nullptr, [footprint](void*) {
+            unregister_tables(footprint);
+        });
+    }
+
+    template<class F>
+    auto apply(F& f) const
+    -> decltype(dispatch::apply(0, nullptr, f)) {
+        return dispatch::apply(index_, const_cast<storage_type*>(&storage_),
+                               f);
+    }
+
+    void destroy() {
+        detail::dispatch_destroy f;
+        apply(f);
+    }
+
+    using storage_type = typename std::aligned_union<0, Dist<Ns>...>::type;
+
+    std::size_t index_;
+    std::shared_ptr<void> registration_;
+    storage_type storage_;
+};
+
+} // namespace etf
+
+#endif // ETF_DISPATCH_HPP
@@ -5,6 +5,8 @@
 #include <stdexcept>
 
 #include "implementation.hpp"
+#include "statistics.hpp"
+#include "table.hpp"
 
 
 /// Exclusive Top Floor namespace.
@@ -14,19 +16,23 @@ namespace etf {
 /// Asymmetric ETF distribution with a rejection-sampled tail.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist=void, typename OuterFunc=void>
+         typename Func, typename OuterDist=void, typename OuterFunc=void,
+         typename Layout=split_layout, typename Storage=heap_storage,
+         typename Statistics=no_statistics>
 class distribution : public
     detail::builder<RealType, W, N,
         detail::asymmetric<RealType, W, N,
             detail::rejection_composite<RealType, W, Func,
-                                        OuterDist, OuterFunc>>>
+                                        OuterDist, OuterFunc>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::asymmetric<RealType, W, N,
                 detail::rejection_composite<RealType, W,
-                    Func, OuterDist, OuterFunc>>>;
+                    Func, OuterDist, OuterFunc>,
+                Layout, Storage, Statistics>>;
     
 public:
     distribution() = default;
@@ -50,6 +56,9 @@ private:
 /// Create a distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist, typename OuterFunc> // implicit
 inline         
@@ -58,8 +67,10 @@ auto make_distribution(InputIt1 x_first, InputIt1 x_last,
                        InputIt3 fsup_first,
                        Func func, OuterDist outer_dist, OuterFunc outer_func,
                        RealType outer_area)
--> etf::distribution<RealType, W, N, Func, OuterDist, OuterFunc> {
-    return etf::distribution<RealType, W, N, Func, OuterDist, OuterFunc>(
+-> etf::distribution<RealType, W, N, Func, OuterDist, OuterFunc, Layout,
+                     Storage, Statistics> {
+    return etf::distribution<RealType, W, N, Func, OuterDist, OuterFunc,
+                             Layout, Storage, Statistics>(
         x_first, x_last, finf_first, fsup_first, func,
         outer_dist, outer_func, outer_area);
 }
@@ -68,17 +79,22 @@ auto make_distribution(InputIt1 x_first, InputIt1 x_last,
 /// Asymmetric ETF distribution with a user-provided tail distribution.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist>
-class distribution<RealType, W, N, Func, OuterDist, void> : public
+         typename Func, typename OuterDist,
+         typename Layout, typename Storage, typename Statistics>
+class distribution<RealType, W, N, Func, OuterDist, void, Layout, Storage,
+                   Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::asymmetric<RealType, W, N,
-            detail::composite<RealType, W, Func, OuterDist>>>
+            detail::composite<RealType, W, Func, OuterDist>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::asymmetric<RealType, W, N,
-                detail::composite<RealType, W, Func, OuterDist>>>;
+                detail::composite<RealType, W, Func, OuterDist>,
+                Layout, Storage, Statistics>>;
     
 public:
     distribution() = default;
@@ -101,6 +117,9 @@ private:
 /// Create a distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist> // implicit
 inline         
@@ -109,25 +128,32 @@ auto make_distribution(InputIt1 x_first, InputIt1 x_last,
                        InputIt3 fsup_first,
                        Func func, OuterDist outer_dist,
                        RealType outer_area)
--> etf::distribution<RealType, W, N, Func, OuterDist> {
-    return etf::distribution<RealType, W, N, Func, OuterDist>(
+-> etf::distribution<RealType, W, N, Func, OuterDist, void, Layout, Storage,
+                     Statistics> {
+    return etf::distribution<RealType, W, N, Func, OuterDist, void,
+                             Layout, Storage, Statistics>(
         x_first, x_last, finf_first, fsup_first, func, outer_dist, outer_area);
 }
 
 
 /// Asymmetric ETF distribution defined on a bounded interval.
 ///
-template<typename RealType, std::size_t W, std::size_t N, typename Func>
-class distribution<RealType, W, N, Func, void, void> : public
+template<typename RealType, std::size_t W, std::size_t N, typename Func,
+         typename Layout, typename Storage, typename Statistics>
+class distribution<RealType, W, N, Func, void, void, Layout, Storage,
+                   Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::asymmetric<RealType, W, N,
-            detail::bounded<RealType, W, Func>>>
+            detail::bounded<RealType, W, Func>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::asymmetric<RealType, W, N,
-                detail::bounded<RealType, W, Func>>>;
+                detail::bounded<RealType, W, Func>,
+                Layout, Storage, Statistics>>;
     
 public:
     distribution() = default;
@@ -149,6 +175,9 @@ private:
 /// Create a distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func> // implicit
 inline         
@@ -156,8 +185,10 @@ auto make_distribution(InputIt1 x_first, InputIt1 x_last,
                        InputIt2 finf_first,
                        InputIt3 fsup_first,
                        Func func)
--> etf::distribution<RealType, W, N, Func> {
-    return etf::distribution<RealType, W, N, Func>(
+-> etf::distribution<RealType, W, N, Func, void, void, Layout, Storage,
+                     Statistics> {
+    return etf::distribution<RealType, W, N, Func, void, void, Layout, Storage,
+                             Statistics>(
         x_first, x_last, finf_first, fsup_first, func);
 }
 
@@ -168,19 +199,23 @@ auto make_distribution(InputIt1 x_first, InputIt1 x_last,
 /// distributions that are symmetric about x=0.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist=void, typename OuterFunc=void>
+         typename Func, typename OuterDist=void, typename OuterFunc=void,
+         typename Layout=split_layout, typename Storage=heap_storage,
+         typename Statistics=no_statistics>
 class central_distribution : public
     detail::builder<RealType, W, N,
         detail::central<RealType, W, N,
             detail::rejection_composite<RealType, W, Func,
-                                        OuterDist, OuterFunc>>>
+                                        OuterDist, OuterFunc>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::central<RealType, W, N,
                 detail::rejection_composite<RealType, W,
-                    Func, OuterDist, OuterFunc>>>;
+                    Func, OuterDist, OuterFunc>,
+                Layout, Storage, Statistics>>;
     
 public:
     central_distribution() = default;
@@ -204,6 +239,9 @@ private:
 /// Create a central_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist, typename OuterFunc> // implicit
 inline         
@@ -213,9 +251,11 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
                                Func func,
                                OuterDist outer_dist, OuterFunc outer_func,
                                RealType outer_area)
--> etf::central_distribution<RealType, W, N, Func, OuterDist, OuterFunc> {
+-> etf::central_distribution<RealType, W, N, Func, OuterDist, OuterFunc,
+                             Layout, Storage, Statistics> {
     return etf::central_distribution<RealType, W, N, Func,
-                                     OuterDist, OuterFunc>(
+                                     OuterDist, OuterFunc, Layout, Storage,
+                                     Statistics>(
         x_first, x_last, finf_first, fsup_first, func,
         outer_dist, outer_func, outer_area);
 }
@@ -227,17 +267,22 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
 /// distributions that are symmetric about x=0.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist>
-class central_distribution<RealType, W, N, Func, OuterDist, void> : public
+         typename Func, typename OuterDist,
+         typename Layout, typename Storage, typename Statistics>
+class central_distribution<RealType, W, N, Func, OuterDist, void,
+                           Layout, Storage, Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::central<RealType, W, N,
-            detail::composite<RealType, W, Func, OuterDist>>>
+            detail::composite<RealType, W, Func, OuterDist>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::central<RealType, W, N,
-                detail::composite<RealType, W, Func, OuterDist>>>;
+                detail::composite<RealType, W, Func, OuterDist>,
+                Layout, Storage, Statistics>>;
     
 
 public:
@@ -261,6 +306,9 @@ private:
 /// Create a central_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist> // implicit
 inline         
@@ -269,8 +317,10 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
                                InputIt3 fsup_first,
                                Func func, OuterDist outer_dist, 
                                RealType outer_area)
--> etf::central_distribution<RealType, W, N, Func, OuterDist> {
-    return etf::central_distribution<RealType, W, N, Func, OuterDist>(
+-> etf::central_distribution<RealType, W, N, Func, OuterDist, void, Layout,
+                             Storage, Statistics> {
+    return etf::central_distribution<RealType, W, N, Func, OuterDist, void,
+                                     Layout, Storage, Statistics>(
         x_first, x_last, finf_first, fsup_first, func, outer_dist, outer_area);
 }
 
@@ -280,17 +330,22 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
 /// This is an efficient specialization of `symmetric_distribution` for
 /// distributions that are symmetric about x=0.
 ///
-template<typename RealType, std::size_t W, std::size_t N, typename Func>
-class central_distribution<RealType, W, N, Func, void, void> : public
+template<typename RealType, std::size_t W, std::size_t N, typename Func,
+         typename Layout, typename Storage, typename Statistics>
+class central_distribution<RealType, W, N, Func, void, void,
+                           Layout, Storage, Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::central<RealType, W, N,
-            detail::bounded<RealType, W, Func>>>
+            detail::bounded<RealType, W, Func>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::central<RealType, W, N,
-                detail::bounded<RealType, W, Func>>>;
+                detail::bounded<RealType, W, Func>,
+                Layout, Storage, Statistics>>;
 
 public:
     central_distribution() = default;
@@ -312,6 +367,9 @@ private:
 /// Create a central_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func> // implicit
 inline         
@@ -319,8 +377,10 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
                                InputIt2 finf_first,
                                InputIt3 fsup_first,
                                Func func)
--> etf::central_distribution<RealType, W, N, Func> {
-    return etf::central_distribution<RealType, W, N, Func>(
+-> etf::central_distribution<RealType, W, N, Func, void, void, Layout,
+                             Storage, Statistics> {
+    return etf::central_distribution<RealType, W, N, Func, void, void,
+                                     Layout, Storage, Statistics>(
         x_first, x_last, finf_first, fsup_first, func);
 }
 
@@ -328,19 +388,23 @@ auto make_central_distribution(InputIt1 x_first, InputIt1 x_last,
 /// Symmetric ETF distribution with a rejection-sampled tail.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist=void, typename OuterFunc=void>
+         typename Func, typename OuterDist=void, typename OuterFunc=void,
+         typename Layout=split_layout, typename Storage=heap_storage,
+         typename Statistics=no_statistics>
 class symmetric_distribution : public
     detail::builder<RealType, W, N,
         detail::symmetric<RealType, W, N,
             detail::rejection_composite<RealType, W, Func,
-                                        OuterDist, OuterFunc>>>
+                                        OuterDist, OuterFunc>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::symmetric<RealType, W, N,
                 detail::rejection_composite<RealType, W,
-                    Func, OuterDist, OuterFunc>>>;
+                    Func, OuterDist, OuterFunc>,
+                Layout, Storage, Statistics>>;
     
 public:
     symmetric_distribution() = default;
@@ -365,6 +429,9 @@ private:
 /// Create a symmetric_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist, typename OuterFunc> // implicit
 auto make_symmetric_distribution(RealType x0,
@@ -374,9 +441,10 @@ auto make_symmetric_distribution(RealType x0,
                                  Func func,
                                  OuterDist outer_dist, OuterFunc outer_func,
                                  RealType outer_area)
--> etf::symmetric_distribution<RealType, W, N, Func, OuterDist, OuterFunc> {
+-> etf::symmetric_distribution<RealType, W, N, Func, OuterDist, OuterFunc,
+                               Layout, Storage, Statistics> {
     return etf::symmetric_distribution<RealType, W, N,
-        Func, OuterDist, OuterFunc>(
+        Func, OuterDist, OuterFunc, Layout, Storage, Statistics>(
             x0, x_first, x_last, finf_first, fsup_first,
             func, outer_dist, outer_func, outer_area);
 }
@@ -385,17 +453,22 @@ auto make_symmetric_distribution(RealType x0,
 /// Symmetric ETF distribution with a user-provided tail distribution.
 ///
 template<typename RealType, std::size_t W, std::size_t N,
-         typename Func, typename OuterDist>
-class symmetric_distribution<RealType, W, N, Func, OuterDist, void> : public
+         typename Func, typename OuterDist,
+         typename Layout, typename Storage, typename Statistics>
+class symmetric_distribution<RealType, W, N, Func, OuterDist, void,
+                             Layout, Storage, Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::symmetric<RealType, W, N,
-            detail::composite<RealType, W, Func, OuterDist>>>
+            detail::composite<RealType, W, Func, OuterDist>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::symmetric<RealType, W, N,
-                detail::composite<RealType, W, Func, OuterDist>>>;
+                detail::composite<RealType, W, Func, OuterDist>,
+                Layout, Storage, Statistics>>;
     
 
 public:
@@ -420,6 +493,9 @@ private:
 /// Create a symmetric_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func, typename OuterDist> // implicit
 auto make_symmetric_distribution(RealType x0,
@@ -428,8 +504,10 @@ auto make_symmetric_distribution(RealType x0,
                                  InputIt3 fsup_first,
                                  Func func, OuterDist outer_dist,
                                  RealType outer_area)
--> etf::symmetric_distribution<RealType, W, N, Func, OuterDist> {
-    return etf::symmetric_distribution<RealType, W, N, Func, OuterDist>(
+-> etf::symmetric_distribution<RealType, W, N, Func, OuterDist, void,
+                               Layout, Storage, Statistics> {
+    return etf::symmetric_distribution<RealType, W, N, Func, OuterDist, void,
+                                       Layout, Storage, Statistics>(
         x0, x_first, x_last, finf_first, fsup_first, func,
         outer_dist, outer_area);
 }
@@ -437,17 +515,22 @@ auto make_symmetric_distribution(RealType x0,
 
 /// Symmetric ETF distribution defined on a bounded interval.
 ///
-template<typename RealType, std::size_t W, std::size_t N, typename Func>
-class symmetric_distribution<RealType, W, N, Func, void, void> : public
+template<typename RealType, std::size_t W, std::size_t N, typename Func,
+         typename Layout, typename Storage, typename Statistics>
+class symmetric_distribution<RealType, W, N, Func, void, void,
+                             Layout, Storage, Statistics>
+    : public
     detail::builder<RealType, W, N,
         detail::symmetric<RealType, W, N,
-            detail::bounded<RealType, W, Func>>>
+            detail::bounded<RealType, W, Func>,
+            Layout, Storage, Statistics>>
 {
 private:
     using Parent =
         detail::builder<RealType, W, N,
             detail::symmetric<RealType, W, N,
-                detail::bounded<RealType, W, Func>>>;
+                detail::bounded<RealType, W, Func>,
+                Layout, Storage, Statistics>>;
 
 public:
     symmetric_distribution() = default;
@@ -470,6 +553,9 @@ private:
 /// Create a symmetric_distribution object, deducing trailing types.
 ///
 template<typename RealType, std::size_t W, std::size_t N, // explicit
+         typename Layout=split_layout, // explicit (optional)
+         typename Storage=heap_storage, // explicit (optional)
+         typename Statistics=no_statistics, // explicit (optional)
          typename InputIt1, typename InputIt2, typename InputIt3, // implicit
          typename Func> // implicit
 auto make_symmetric_distribution(RealType x0,
@@ -477,8 +563,10 @@ auto make_symmetric_distribution(RealType x0,
                                  InputIt2 finf_first,
                                  InputIt3 fsup_first,
                                  Func func)
--> etf::symmetric_distribution<RealType, W, N, Func> {
-    return etf::symmetric_distribution<RealType, W, N, Func>(
+-> etf::symmetric_distribution<RealType, W, N, Func, void, void, Layout,
+                               Storage, Statistics> {
+    return etf::symmetric_distribution<RealType, W, N, Func, void, void,
+                                       Layout, Storage, Statistics>(
         x0, x_first, x_last, finf_first, fsup_first, func);
 }
 
@@ -17,6 +17,32 @@ public:
     invalid_table_size() : std::invalid_argument("Invalid ETF table size") {}
 };
 
+
+/// Exception thrown when the computation of an ETF partition fails to
+/// converge.
+///
+/// When the partition is computed at compile time, the exception turns the
+/// failure into a compilation error. At run time, it is thrown when the Newton
+/// solver returns an empty partition, notably by `partition_family`,
+/// `cached_partition`, `tune_distribution`, `tune_central_distribution` and
+/// the constructors of the standard distributions.
+///
+class partition_convergence_error : public std::runtime_error {
+public:
+    partition_convergence_error()
+    : std::runtime_error("ETF partition solver failed to converge") {}
+};
+
+
+/// Exception thrown when a partition file cannot be read or written, or does
+/// not match the requested key.
+///
+class table_cache_error : public std::runtime_error {
+public:
+    explicit table_cache_error(const char* what)
+    : std::runtime_error(what) {}
+};
+
 } // namespace etf
 
 #endif // ETF_EXCEPTIONS_HPP
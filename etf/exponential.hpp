@@ -0,0 +1,265 @@
+#ifndef ETF_EXPONENTIAL_HPP
+#define ETF_EXPONENTIAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "exceptions.hpp"
+#include "implementation.hpp"
+#include "standard_partitions.hpp"
+#include "statistics.hpp"
+#include "table.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Probability density function of the standard exponential distribution.
+template<typename RealType>
+struct exponential_pdf
+{
+    RealType operator()(RealType x) const {
+        return std::exp(-x);
+    }
+};
+
+
+// Standard exponential ETF distribution with shared tables.
+//
+// The tail beyond the table is the distribution itself shifted by the tail
+// position, so outer hits simply loop back into the table.
+template<typename RealType, std::size_t W, std::size_t N>
+class standard_exponential : public
+    builder<RealType, W, N,
+        asymmetric<RealType, W, N,
+            self_similar_composite<RealType, W, exponential_pdf<RealType>>,
+            split_layout, shared_storage, no_statistics>>
+{
+private:
+    using Parent =
+        builder<RealType, W, N,
+            asymmetric<RealType, W, N,
+                self_similar_composite<RealType, W,
+                                       exponential_pdf<RealType>>,
+                split_layout, shared_storage, no_statistics>>;
+
+public:
+    standard_exponential() = default;
+
+    template<typename InputIt1, typename InputIt2, typename InputIt3>
+    standard_exponential(InputIt1 x_first, InputIt1 x_last,
+                         InputIt2 finf_first, InputIt3 fsup_first,
+                         RealType tail_area)
+    : Parent(exponential_pdf<RealType>()) {
+        this->build(0.0, x_first, x_last, finf_first, fsup_first, tail_area);
+    }
+
+private:
+    using Parent::build;
+};
+
+
+// The partition is computed at run time.
+template<typename RealType, std::size_t W, std::size_t N>
+standard_exponential<RealType, W, N>
+make_standard_exponential(std::false_type) {
+    exponential_pdf<RealType> pdf;
+    const std::size_t n = std::size_t(1) << N;
+    const RealType xtail = exponential_xtail<RealType>(W, N);
+    const RealType tail_area = std::exp(-xtail);
+
+    const RealType rel_tol = std::numeric_limits<RealType>::epsilon()
+                           * RealType(1e4);
+    auto x_guess = trapezoidal_rule_prepartition(pdf, RealType(0.0), xtail,
+                                                 n);
+    auto dpdf = [](RealType x) { return -std::exp(-x); };
+    auto p = newton_partition_monotonic(pdf, dpdf,
+                                        x_guess.begin(), x_guess.end(),
+                                        rel_tol);
+    if (p.x.empty())
+        throw partition_convergence_error();
+
+    return standard_exponential<RealType, W, N>(
+        p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(), tail_area);
+}
+
+
+#if __cplusplus >= 201703L
+// The partition is computed at compile time.
+template<typename RealType, std::size_t W, std::size_t N>
+standard_exponential<RealType, W, N>
+make_standard_exponential(std::true_type) {
+    using Partition = static_exponential_partition<RealType, W, N>;
+    const auto& p = Partition::partition;
+    return standard_exponential<RealType, W, N>(
+        p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(),
+        Partition::tail_area);
+}
+#endif
+
+
+template<typename RealType, std::size_t W, std::size_t N>
+standard_exponential<RealType, W, N> make_standard_exponential() {
+    return make_standard_exponential<RealType, W, N>(
+        use_static_partition<N>());
+}
+
+
+// Returns a standard exponential ETF distribution.
+//
+// The tables are computed on the first call and are then shared by all
+// copies of the returned object.
+template<typename RealType, std::size_t W, std::size_t N>
+const standard_exponential<RealType, W, N>& standard_exponential_tables() {
+    static const standard_exponential<RealType, W, N> d =
+        make_standard_exponential<RealType, W, N>();
+    return d;
+}
+
+} // namespace detail
+
+
+/// Exponential distribution.
+///
+/// This distribution has the same interface as
+/// `std::exponential_distribution`. Standard exponential variates are
+/// generated with an ETF distribution which exploits the memorylessness of
+/// the exponential distribution: when the tail is selected, sampling starts
+/// over from the table and the tail position is added to the result, so that
+/// no logarithm is ever computed.
+///
+/// As for `normal_distribution`, the tables are computed once and shared by
+/// all distribution objects.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class exponential_distribution
+{
+public:
+    using result_type = RealType;
+
+    /// Distribution parameters.
+    ///
+    class param_type
+    {
+    public:
+        using distribution_type = exponential_distribution;
+
+        explicit param_type(RealType lambda=1.0)
+        : lambda_(lambda), inv_lambda_(RealType(1.0)/lambda) {}
+
+        RealType lambda() const { return lambda_; }
+
+        friend bool operator==(const param_type& a, const param_type& b) {
+            return a.lambda_==b.lambda_;
+        }
+
+        friend bool operator!=(const param_type& a, const param_type& b) {
+            return !(a==b);
+        }
+
+    private:
+        friend class exponential_distribution;
+
+        RealType lambda_;
+        RealType inv_lambda_;
+    };
+
+    exponential_distribution() : exponential_distribution(1.0) {}
+
+    explicit exponential_distribution(RealType lambda)
+    : exponential_distribution(param_type(lambda)) {}
+
+    explicit exponential_distribution(const param_type& params)
+    : params_(params),
+      z_(detail::standard_exponential_tables<RealType, W, N>()) {}
+
+    void reset() {}
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        return (*this)(g, params_);
+    }
+
+    /// Returns a random number generated with the specified parameters.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g, const param_type& params) const {
+        return z_(g)*params.inv_lambda_;
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        z_.generate(first, last, g);
+        for (; first!=last; ++first)
+            *first = (*first)*params_.inv_lambda_;
+    }
+
+    RealType lambda() const { return params_.lambda(); }
+
+    param_type param() const { return params_; }
+
+    void param(const param_type& params) { params_ = params; }
+
+    result_type min() const {
+        return RealType(0.0);
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    friend bool operator==(const exponential_distribution& a,
+                           const exponential_distribution& b) {
+        return a.params_==b.params_;
+    }
+
+    friend bool operator!=(const exponential_distribution& a,
+                           const exponential_distribution& b) {
+        return !(a==b);
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const exponential_distribution& d) {
+        auto flags = os.flags(std::ios_base::scientific);
+        auto precision = os.precision(
+            std::numeric_limits<RealType>::max_digits10);
+        os << d.lambda();
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               exponential_distribution& d) {
+        auto flags = is.flags(std::ios_base::dec | std::ios_base::skipws);
+        RealType lambda;
+        if (is >> lambda)
+            d.param(param_type(lambda));
+        is.flags(flags);
+        return is;
+    }
+
+private:
+    param_type params_;
+    detail::standard_exponential<RealType, W, N> z_;
+};
+
+} // namespace etf
+
+#endif // ETF_EXPONENTIAL_HPP
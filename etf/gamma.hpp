@@ -0,0 +1,562 @@
+#ifndef ETF_GAMMA_HPP
+#define ETF_GAMMA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "distribution.hpp"
+#include "exceptions.hpp"
+#include "random_digits.hpp"
+#include "standard_partitions.hpp"
+#include "table.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Non-normalized probability density function of the standard gamma
+// distribution with shape parameter `alpha`.
+//
+// The function is `x^m*exp(-x)` with `m=alpha-1`. If `alpha>1`, it is scaled
+// to 1 at the mode and evaluated relatively to the mode so as to avoid
+// overflows and cancellations for large shape parameters.
+template<typename RealType>
+class gamma_pdf
+{
+public:
+    gamma_pdf() = default;
+
+    explicit gamma_pdf(RealType alpha) : m_(alpha - RealType(1.0)) {}
+
+    RealType operator()(RealType x) const {
+        return std::exp(log_value(x));
+    }
+
+    // Returns the logarithm of the function.
+    RealType log_value(RealType x) const {
+        if (m_>RealType(0.0)) {
+            if (x<=RealType(0.0))
+                return -std::numeric_limits<RealType>::infinity();
+            RealType d = (x - m_)/m_;
+            return m_*(std::log1p(d) - d);
+        }
+        if (m_==RealType(0.0))
+            return -x;
+        return m_*std::log(x) - x;
+    }
+
+    RealType derivative(RealType x) const {
+        return (*this)(x)*(m_/x - RealType(1.0));
+    }
+
+    // Returns the logarithm of the total area under the function.
+    RealType log_area() const {
+        RealType c = m_>RealType(0.0) ? m_ - m_*std::log(m_) : RealType(0.0);
+        return std::lgamma(m_ + RealType(1.0)) + c;
+    }
+
+    RealType m() const { return m_; }
+
+private:
+    RealType m_;
+};
+
+
+// Returns the scale of the exponential distribution majorizing the tail of
+// the gamma distribution beyond `xtail`.
+//
+// If `alpha>1`, the logarithm of the density is concave and the majorizing
+// function is its tangent at `xtail`; otherwise `x^m` is decreasing and
+// `exp(-x)` majorizes the density once scaled to match it at `xtail`.
+template<typename RealType>
+RealType gamma_tail_scale(RealType m, RealType xtail) {
+    return m>RealType(0.0) ? xtail/(xtail - m) : RealType(1.0);
+}
+
+
+// Outer distribution of the standard gamma distribution.
+//
+// The right tail beyond `xtail` is sampled with an exponential distribution
+// (a Weibull distribution with shape parameter 1) majorizing the gamma
+// density. If `alpha<1`, the density is unbounded at 0 and the interval
+// [0, `x0`) is sampled as well, using the power-law `x^(alpha-1)` as
+// majorizing function which is sampled by inversion.
+template<typename RealType, std::size_t W>
+class gamma_outer_distribution
+{
+public:
+    gamma_outer_distribution() = default;
+
+    gamma_outer_distribution(const gamma_pdf<RealType>& pdf,
+                             RealType x0, RealType xtail)
+    : x0_(x0), inv_alpha_(RealType(1.0)/(pdf.m() + RealType(1.0))),
+      tail_dist_(xtail, RealType(1.0),
+                 gamma_tail_scale(pdf.m(), xtail), xtail)
+    {
+        const RealType b = gamma_tail_scale(pdf.m(), xtail);
+        const RealType right_area = b*pdf(xtail);
+        const RealType left_area = x0>RealType(0.0) ?
+            std::pow(x0, pdf.m() + RealType(1.0))*inv_alpha_ : RealType(0.0);
+        area_ = left_area + right_area;
+        left_switch_ = left_area/area_;
+    }
+
+    template<class RngType>
+    RealType operator()(RngType& g) const {
+        if (left_switch_>RealType(0.0) &&
+            generate_random_real<RealType, W>(g)<left_switch_) {
+            // Power-law sampling over (0, x0].
+            RealType u = RealType(1.0) - generate_random_real<RealType, W>(g);
+            return x0_*std::pow(u, inv_alpha_);
+        }
+        return tail_dist_(g);
+    }
+
+    // Returns the area under the majorizing function.
+    RealType area() const {
+        return area_;
+    }
+
+    RealType min() const {
+        return RealType(0.0);
+    }
+
+    RealType max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    void reset() {}
+
+private:
+    RealType x0_;
+    RealType inv_alpha_;
+    RealType area_;
+    RealType left_switch_;
+    weibull_tail_distribution<RealType, W> tail_dist_;
+};
+
+
+// Majorizing function of the outer distribution of the standard gamma
+// distribution.
+template<typename RealType>
+class gamma_outer_pdf
+{
+public:
+    gamma_outer_pdf() = default;
+
+    gamma_outer_pdf(const gamma_pdf<RealType>& pdf,
+                    RealType x0, RealType xtail)
+    : m_(pdf.m()), x_switch_(RealType(0.5)*(x0 + xtail)),
+      tail_pdf_(RealType(1.0), gamma_tail_scale(pdf.m(), xtail), xtail,
+                gamma_tail_scale(pdf.m(), xtail)*pdf(xtail)) {}
+
+    RealType operator()(RealType x) const {
+        return x<x_switch_ ? std::pow(x, m_) : tail_pdf_(x);
+    }
+
+private:
+    RealType m_;
+    RealType x_switch_;
+    weibull_pdf<RealType> tail_pdf_;
+};
+
+
+// Standard gamma ETF distribution with shared tables.
+template<typename RealType, std::size_t W, std::size_t N>
+using standard_gamma =
+    distribution<RealType, W, N, gamma_pdf<RealType>,
+                 gamma_outer_distribution<RealType, W>,
+                 gamma_outer_pdf<RealType>,
+                 split_layout, shared_storage>;
+
+
+// Returns the tail position of a standard gamma ETF distribution.
+//
+// The tail area is about exp(-exponential_xtail) of the total area, as for
+// the exponential distribution, which is the special case `alpha=1`. The
+// tail position is found by bisection since the logarithm of the tail area
+// is decreasing beyond the mode.
+template<typename RealType>
+RealType gamma_xtail(const gamma_pdf<RealType>& pdf, RealType log_ratio) {
+    const RealType m = pdf.m();
+    const RealType log_target = pdf.log_area() - log_ratio;
+    auto h = [&pdf, m, log_target](RealType x) {
+        return std::log(gamma_tail_scale(m, x)) + pdf.log_value(x)
+             - log_target;
+    };
+
+    RealType lo = std::max(m, RealType(0.0));
+    RealType hi = lo + RealType(1.0);
+    while (h(hi)>RealType(0.0)) {
+        lo = hi;
+        hi *= RealType(2.0);
+    }
+    for (int k=0; k!=std::numeric_limits<RealType>::digits; ++k) {
+        RealType mid = RealType(0.5)*(lo + hi);
+        if (!(mid>lo && mid<hi))
+            break;
+        if (h(mid)>RealType(0.0))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return hi;
+}
+
+
+// Returns the lower bound of the table of a standard gamma ETF distribution.
+//
+// This is 0 if `alpha>=1`. Otherwise, the area of the power-law sampled over
+// [0, `x0`) is about exp(-log_ratio) of the total area. The bound is kept
+// large enough for the density to remain finite.
+template<typename RealType>
+RealType gamma_x0(const gamma_pdf<RealType>& pdf, RealType log_ratio) {
+    const RealType alpha = pdf.m() + RealType(1.0);
+    if (alpha>=RealType(1.0))
+        return RealType(0.0);
+    const RealType log_x0 =
+        (pdf.log_area() - log_ratio + std::log(alpha))/alpha;
+    const RealType x0_min =
+        std::sqrt(std::numeric_limits<RealType>::min());
+    return std::max(std::exp(log_x0), x0_min);
+}
+
+
+template<typename RealType, std::size_t W, std::size_t N>
+standard_gamma<RealType, W, N> make_standard_gamma(RealType alpha) {
+    const std::size_t n = std::size_t(1) << N;
+    const gamma_pdf<RealType> pdf(alpha);
+    const RealType m = pdf.m();
+    const RealType log_ratio = exponential_xtail<RealType>(W, N);
+    const RealType xtail = gamma_xtail(pdf, log_ratio);
+    const RealType x0 = gamma_x0(pdf, log_ratio);
+
+    // The achievable accuracy decreases as the width of the sub-intervals
+    // around the mode becomes small relatively to their abscissae.
+    const RealType rel_tol = std::numeric_limits<RealType>::epsilon()
+                           * RealType(1e4)
+                           * std::max(RealType(1.0), std::sqrt(alpha));
+    auto dpdf = [&pdf](RealType x) { return pdf.derivative(x); };
+    partition_data<RealType> p;
+    if (alpha<RealType(1.0)) {
+        // The density is unbounded at 0 so the abscissae are initially
+        // evenly distributed with respect to the area in the variable
+        // t=x^alpha, where the density exp(-t^(1/alpha)) is bounded.
+        const RealType inv_alpha = RealType(1.0)/alpha;
+        auto t_pdf = [inv_alpha](RealType t) {
+            return std::exp(-std::pow(t, inv_alpha));
+        };
+        auto t_guess = trapezoidal_rule_prepartition(
+            t_pdf, std::pow(x0, alpha), std::pow(xtail, alpha), n, 4*n);
+        for (auto& t : t_guess)
+            t = std::pow(t, inv_alpha);
+        t_guess.front() = x0;
+        t_guess.back() = xtail;
+        p = newton_partition_monotonic(pdf, dpdf,
+                                       t_guess.begin(), t_guess.end(),
+                                       rel_tol);
+    }
+    else {
+        auto x_guess = adaptive_simpson_prepartition(pdf, RealType(0.0),
+                                                     xtail, n);
+        if (m>RealType(0.0)) {
+            RealType x_mode[1] = { m };
+            p = newton_partition(pdf, dpdf,
+                                 x_guess.begin(), x_guess.end(),
+                                 x_mode, x_mode + 1, rel_tol);
+        }
+        else {
+            p = newton_partition_monotonic(pdf, dpdf,
+                                           x_guess.begin(), x_guess.end(),
+                                           rel_tol);
+        }
+    }
+    if (p.x.empty())
+        throw partition_convergence_error();
+
+    // Lift the suprema so that all upper rectangles have the same area.
+    equalize_upper_areas(p);
+
+    gamma_outer_distribution<RealType, W> outer_dist(pdf, x0, xtail);
+    gamma_outer_pdf<RealType> outer_pdf(pdf, x0, xtail);
+
+    return make_distribution<RealType, W, N, split_layout, shared_storage>(
+        p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(),
+        pdf, outer_dist, outer_pdf, outer_dist.area());
+}
+
+
+// Bounded cache of values indexed by a key, which evicts the least recently
+// used value when full.
+//
+// The cache is safe to use concurrently. Values are computed while the cache
+// is locked so that a value is never computed twice.
+template<typename Key, typename Value>
+class lru_cache
+{
+public:
+    explicit lru_cache(std::size_t capacity) : capacity_(capacity) {}
+
+    // Returns the value associated to the key, computing it with `make()` if
+    // it is not cached.
+    template<class MakeFunc>
+    Value get(const Key& key, MakeFunc make) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it!=index_.end()) {
+            values_.splice(values_.begin(), values_, it->second);
+            return it->second->second;
+        }
+        Value value = make();
+        if (capacity_!=0) {
+            values_.emplace_front(key, value);
+            index_[key] = values_.begin();
+            evict();
+        }
+        return value;
+    }
+
+    std::size_t capacity() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capacity_;
+    }
+
+    void capacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        evict();
+    }
+
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return values_.size();
+    }
+
+private:
+    void evict() {
+        while (values_.size()>capacity_) {
+            index_.erase(values_.back().first);
+            values_.pop_back();
+        }
+    }
+
+    using List = std::list<std::pair<Key, Value>>;
+
+    std::size_t capacity_;
+    List values_;
+    std::map<Key, typename List::iterator> index_;
+    std::mutex mutex_;
+};
+
+
+// Default number of shape parameters whose tables are cached.
+constexpr std::size_t gamma_table_cache_capacity = 16;
+
+
+// Returns the cache of the standard gamma tables.
+template<typename RealType, std::size_t W, std::size_t N>
+lru_cache<RealType, standard_gamma<RealType, W, N>>& gamma_table_cache() {
+    static lru_cache<RealType, standard_gamma<RealType, W, N>> cache(
+        gamma_table_cache_capacity);
+    return cache;
+}
+
+
+// Returns a standard gamma ETF distribution.
+//
+// The tables are looked up in the cache and are computed if missing; they
+// are shared by all copies of the returned object. The shape parameter is
+// validated beforehand since a NaN key would break the ordering of the cache.
+template<typename RealType, std::size_t W, std::size_t N>
+standard_gamma<RealType, W, N> standard_gamma_tables(RealType alpha) {
+    if (!(alpha>RealType(0.0)) ||
+        !(alpha<std::numeric_limits<RealType>::max()))
+        throw std::invalid_argument("invalid gamma shape parameter");
+
+    return gamma_table_cache<RealType, W, N>().get(alpha, [alpha]() {
+        return make_standard_gamma<RealType, W, N>(alpha);
+    });
+}
+
+} // namespace detail
+
+
+/// Gamma distribution.
+///
+/// This distribution has the same interface as `std::gamma_distribution`,
+/// with shape parameter `alpha` and scale parameter `beta`.
+///
+/// Standard gamma variates are generated with an ETF distribution specific to
+/// the shape parameter. Its tail is majorized by an exponential distribution
+/// and, for shape parameters lower than 1, its neighborhood of 0, where the
+/// density is unbounded, is majorized by a power-law. The tail position and
+/// the power-law range are set automatically.
+///
+/// The tables are held by `param_type` objects. They are memoized in a
+/// bounded cache shared by all distributions with the same template
+/// parameters, which evicts the least recently used shape parameter when
+/// full, so that creating a distribution with a recently used shape
+/// parameter is cheap. Computing the tables for a new shape parameter is
+/// comparatively costly: frequently changing shape parameters should rather
+/// be used with a `param_type` object created once.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class gamma_distribution
+{
+public:
+    using result_type = RealType;
+
+    /// Distribution parameters.
+    ///
+    class param_type
+    {
+    public:
+        using distribution_type = gamma_distribution;
+
+        explicit param_type(RealType alpha=1.0, RealType beta=1.0)
+        : alpha_(alpha), beta_(beta),
+          z_(detail::standard_gamma_tables<RealType, W, N>(alpha)) {}
+
+        RealType alpha() const { return alpha_; }
+
+        RealType beta() const { return beta_; }
+
+        friend bool operator==(const param_type& a, const param_type& b) {
+            return a.alpha_==b.alpha_ && a.beta_==b.beta_;
+        }
+
+        friend bool operator!=(const param_type& a, const param_type& b) {
+            return !(a==b);
+        }
+
+    private:
+        friend class gamma_distribution;
+
+        RealType alpha_;
+        RealType beta_;
+        detail::standard_gamma<RealType, W, N> z_;
+    };
+
+    gamma_distribution() : gamma_distribution(1.0) {}
+
+    explicit gamma_distribution(RealType alpha, RealType beta=1.0)
+    : gamma_distribution(param_type(alpha, beta)) {}
+
+    explicit gamma_distribution(const param_type& params)
+    : params_(params) {}
+
+    void reset() {}
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        return (*this)(g, params_);
+    }
+
+    /// Returns a random number generated with the specified parameters.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g, const param_type& params) const {
+        return params.z_(g)*params.beta_;
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        params_.z_.generate(first, last, g);
+        for (; first!=last; ++first)
+            *first = (*first)*params_.beta_;
+    }
+
+    RealType alpha() const { return params_.alpha(); }
+
+    RealType beta() const { return params_.beta(); }
+
+    param_type param() const { return params_; }
+
+    void param(const param_type& params) { params_ = params; }
+
+    result_type min() const {
+        return RealType(0.0);
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    /// Returns the maximum number of shape parameters whose tables are
+    /// cached.
+    ///
+    static std::size_t table_cache_capacity() {
+        return detail::gamma_table_cache<RealType, W, N>().capacity();
+    }
+
+    /// Sets the maximum number of shape parameters whose tables are cached.
+    ///
+    /// Tables evicted from the cache remain valid as long as they are used by
+    /// a distribution or a `param_type` object.
+    ///
+    static void table_cache_capacity(std::size_t capacity) {
+        detail::gamma_table_cache<RealType, W, N>().capacity(capacity);
+    }
+
+    friend bool operator==(const gamma_distribution& a,
+                           const gamma_distribution& b) {
+        return a.params_==b.params_;
+    }
+
+    friend bool operator!=(const gamma_distribution& a,
+                           const gamma_distribution& b) {
+        return !(a==b);
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const gamma_distribution& d) {
+        auto flags = os.flags(std::ios_base::scientific);
+        auto precision = os.precision(
+            std::numeric_limits<RealType>::max_digits10);
+        os << d.alpha() << os.widen(' ') << d.beta();
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               gamma_distribution& d) {
+        auto flags = is.flags(std::ios_base::dec | std::ios_base::skipws);
+        RealType alpha;
+        RealType beta;
+        if (is >> alpha >> beta)
+            d.param(param_type(alpha, beta));
+        is.flags(flags);
+        return is;
+    }
+
+private:
+    param_type params_;
+};
+
+} // namespace etf
+
+#endif // ETF_GAMMA_HPP
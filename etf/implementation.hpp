@@ -3,49 +3,38 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <iterator>
+#include <limits>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "exceptions.hpp"
 #include "random_digits.hpp"
+#include "simd.hpp"
+#include "statistics.hpp"
+#include "table.hpp"
 
 
 namespace etf {
 
-namespace detail {
-
-template<typename RealType, std::size_t W>
-class data {
-public:
-    using result_type = RealType;
-
-protected:
-    using UIntType = typename etf::integer_traits<W>::uint_least_t;
-
-private:
-    struct Datum
-    {
-        UIntType scaled_fratio;
-        RealType scaled_fsup;
-        RealType scaled_dx;
-    };
+template<class Distribution>
+class truncated_distribution;
 
-protected:
-    std::vector<RealType> x_;
-    std::vector<Datum> data_;
-};
 
+namespace detail {
 
 template<typename RealType, std::size_t W, typename Func>
-class bounded : public data<RealType, W>
+class bounded
 {
-private:
-    using Parent = data<RealType, W>;
+public:
+    using result_type = RealType;
 
 protected:
-    using UIntType = typename Parent::UIntType;
+    using UIntType = typename etf::integer_traits<W>::uint_least_t;
 
 public:
     template<typename=void>
@@ -58,10 +47,12 @@ protected:
 
     void define_outer_switch(UIntType) {}; // never called
 
-    UIntType outer_switch() { return 0; } // never called
+    UIntType outer_switch() const { return 0; } // never called
 
     template<class RngType>
-    bool sample_outer(RngType& g, RealType& x) { return false; } // never called
+    bool sample_outer(RngType&, RealType&) const {
+        return false; // never called
+    }
 
     template<typename=void>
     RealType outer_min() const { return 0.0; } // never called
@@ -73,6 +64,7 @@ protected:
     Func func_;
     static constexpr bool HasOuter = false;
     static constexpr bool HasRejection = false;
+    static constexpr bool IsSelfSimilar = false;
 };
 
 
@@ -102,7 +94,7 @@ protected:
         outer_switch_ = outer_switch;
     }
 
-    UIntType outer_switch() {
+    UIntType outer_switch() const {
         return outer_switch_;
     }
 
@@ -113,6 +105,13 @@ protected:
         return true;
     }
 
+    template<class RngType>
+    bool sample_outer(RngType& g, RealType& x) const
+    {
+        x = outer_dist_(g);
+        return true;
+    }
+
     template<typename=void>
     RealType outer_min() const {
         return outer_dist_.min();
@@ -156,126 +155,351 @@ protected:
         return r*outer_func_(x) <= this->func_(x);
     }
 
+    template<class RngType>
+    bool sample_outer(RngType& g, RealType& x) const
+    {
+        RealType r = generate_random_real<RealType, W>(g);
+        x = this->outer_dist_(g);
+        return r*outer_func_(x) <= this->func_(x);
+    }
+
 protected:
     OuterFunc outer_func_;
     static constexpr bool HasRejection = true;
 };
 
 
-template<typename RealType, std::size_t W, std::size_t N, class Category>
-class asymmetric : public Category
+// Category of distributions whose tail is the whole distribution shifted by
+// the extent of the table, i.e. f(x + (x_last - x_first)) is proportional to
+// f(x), as is the case for the exponential distribution.
+//
+// There is no outer distribution: an outer hit simply starts over from the
+// table with the sample shifted by the table extent, which yields an exact
+// tail without any rejection or transcendental function evaluation.
+template<typename RealType, std::size_t W, typename Func>
+class self_similar_composite : public bounded<RealType, W, Func>
+{
+private:
+    using Parent = bounded<RealType, W, Func>;
+
+protected:
+    using UIntType = typename Parent::UIntType;
+
+protected:
+    self_similar_composite() = default;
+
+    self_similar_composite(Func func) : Parent(func) {}
+
+    void define_outer_switch(UIntType outer_switch) {
+        outer_switch_ = outer_switch;
+    }
+
+    UIntType outer_switch() const {
+        return outer_switch_;
+    }
+
+    template<typename=void>
+    RealType outer_min() const {
+        return std::numeric_limits<RealType>::max(); // neutral for min()
+    }
+
+    template<typename=void>
+    RealType outer_max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+protected:
+    UIntType outer_switch_;
+    static constexpr bool HasOuter = true;
+    static constexpr bool HasRejection = false;
+    static constexpr bool IsSelfSimilar = true;
+};
+
+
+// Converts a mantissa to a floating point number.
+//
+// Mantissas never use the most significant bit of their integer type, so the
+// conversion can go through the corresponding signed type, which is faster on
+// most platforms and vectorizes without extended instruction sets.
+template<typename RealType, typename UIntType>
+inline RealType to_real(UIntType u) {
+    using IntType = typename std::make_signed<UIntType>::type;
+    return static_cast<RealType>(static_cast<IntType>(u));
+}
+
+
+// Number of variates processed at a time by bulk generation functions.
+constexpr std::size_t generation_block_size = 128;
+
+
+// Fills a range with variates generated block-wise.
+//
+// Each block is processed in 3 passes: random numbers are first generated for
+// the whole block, then the fast path is attempted for each random number and
+// the indices of the misses are compacted, and finally the misses (wedges and
+// outer samples) are resolved one by one. This keeps the branch-free fast path
+// out of the way of the rare, unpredictable branches.
+template<typename RealType, typename UIntType, std::size_t W,
+         class ForwardIt, class RngType, class FastBlockFunc, class SlowFunc>
+void generate_blocks(ForwardIt first, ForwardIt last, RngType& g,
+                     FastBlockFunc sample_fast_block, SlowFunc sample_slow) {
+    constexpr std::size_t B = generation_block_size;
+    UIntType r[B];
+    RealType x[B];
+    unsigned short miss[B];
+    
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    while (n!=0) {
+        const std::size_t m = n<B ? n : B;
+        
+        generate_random_integers<UIntType, W>(g, r, m);
+        
+        std::size_t nb_miss = sample_fast_block(r, x, m, miss);
+        
+        for (std::size_t j=0; j!=nb_miss; ++j)
+            x[miss[j]] = sample_slow(g, r[miss[j]]);
+        
+        first = std::copy(x, x + m, first);
+        n -= m;
+    }
+}
+
+
+template<typename RealType, std::size_t W, std::size_t N, class Category,
+         class Layout, class Storage, class Statistics>
+class asymmetric : public Category, public statistics_recorder<Statistics>
 {
 protected:
     using UIntType = typename Category::UIntType;
+    using Table = detail::table<RealType, UIntType, N, Layout, Storage>;
 
 public:
     /// Returns a random number.
     ///
     template<class RngType>
     RealType operator()(RngType& g) {
-        while (true)
-        {
-            // Generate a table index and a positive value from a single random
-            // number.
-            auto r = generate_random_integer<UIntType, W>(g);
-            // Mantissa is made of bits 0:(W-N-1).
-            constexpr UIntType m_mask = (UIntType(1) << (W - N)) - 1;
-            UIntType u = r & m_mask;
-            // The table index is made of bits (W-N):(W-1).
-            auto i = std::size_t(r >> (W - N));
-            
-            const auto& d = this->data_[i];
-            // Note that the following test will also fail if 'u' is greater or
-            // equal to the outer switch value since all 'fratio' values are
-            // lower than the switch value.
-            if (u<d.scaled_fratio)
-                return this->x_[i] + d.scaled_dx*u;
-            
-            // Should the outer distribution be sampled?
-            if (Category::HasOuter && u>=this->outer_switch()) {
-                RealType x;
-                bool acceptance = this->sample_outer(g, x);
-                if (!Category::HasRejection || acceptance)
-                    return x;
-            }
+        return sample(*this, g);
+    }
 
-            // Otherwise it is a wedge, test y<f(x) for rejection sampling.
-            RealType v = generate_random_real<RealType, W>(g); // v in [0,1)
-            RealType x = this->x_[i] + v*(this->x_[i+1] - this->x_[i]);
-            if ((u*d.scaled_fsup) < this->func_(x))
-                return x;
-        }
+    /// Returns a random number without modifying the distribution.
+    ///
+    /// This overload requires the `no_statistics` policy and a density
+    /// function and outer distribution callable on const objects.
+    ///
+    template<class RngType>
+    RealType operator()(RngType& g) const {
+        return sample(*this, g);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) {
+        generate_range(*this, first, last, g);
+    }
+
+    /// Fills a range with random numbers without modifying the distribution.
+    ///
+    /// This overload has the same requirements as the const `operator()`.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        generate_range(*this, first, last, g);
     }
 
     template<typename=void>
     RealType min() const {
-        RealType m = std::min(this->x_.front(), this->x_.back());
+        RealType m = std::min(table_.x_first(), table_.x_last());
         return Category::HasOuter? std::min(m, this->outer_min()) : m;
     }
     
     template<typename=void>
     RealType max() const {
-        RealType m = std::max(this->x_.front(), this->x_.back());
+        RealType m = std::max(table_.x_first(), table_.x_last());
         return Category::HasOuter? std::max(m, this->outer_max()) : m;
     }
     
 protected:
     using Category::Category;
 
+    // Attempts to generate a number from the random integer using the fast
+    // path only.
+    //
+    // The candidate value is computed unconditionally and is only valid if
+    // true is returned.
+    bool sample_fast(UIntType r, RealType& x) const {
+        // Mantissa is made of bits 0:(W-N-1).
+        constexpr UIntType m_mask = (UIntType(1) << (W - N)) - 1;
+        UIntType u = r & m_mask;
+        // The table index is made of bits (W-N):(W-1).
+        auto i = std::size_t(r >> (W - N));
+        
+        const auto& d = table_[i];
+        x = table_.x(i) + d.scaled_dx*to_real<RealType>(u);
+        // Note that the following test will also fail if 'u' is greater or
+        // equal to the outer switch value since all 'fratio' values are
+        // lower than the switch value.
+        return u<d.scaled_fratio;
+    }
+
+    // Attempts the fast path on a block of random integers.
+    //
+    // The indices of the random integers which missed the fast path are
+    // written to `miss` and their number is returned.
+    std::size_t sample_fast_block(const UIntType* r, RealType* x,
+                                  std::size_t m, unsigned short* miss) const {
+        std::size_t nb_miss = 0;
+        for (std::size_t k=0; k!=m; ++k) {
+            bool hit = sample_fast(r[k], x[k]);
+            miss[nb_miss] = static_cast<unsigned short>(k);
+            nb_miss += hit ? 0 : 1;
+        }
+        return nb_miss;
+    }
+
+    // Generates a number.
+    //
+    // The sampling functions are static so that they can be shared by the
+    // const and non-const members; `Self` is the possibly const-qualified
+    // type of the distribution.
+    template<class Self, class RngType>
+    static RealType sample(Self& self, RngType& g) {
+        auto&& h = self.engine(g);
+        self.record_samples(1);
+        auto r = generate_random_integer<UIntType, W>(h);
+        RealType x;
+        if (self.sample_fast(r, x)) {
+            self.record_fast(1);
+            return x;
+        }
+        return sample_slow(self, h, r);
+    }
+
+    // Fills a range with numbers generated block-wise.
+    template<class Self, class ForwardIt, class RngType>
+    static void generate_range(Self& self, ForwardIt first, ForwardIt last,
+                               RngType& g) {
+        auto&& h = self.engine(g);
+        using Engine = typename std::remove_reference<decltype(h)>::type;
+        detail::generate_blocks<RealType, UIntType, W>(first, last, h,
+            [&self](const UIntType* r, RealType* x, std::size_t m,
+                    unsigned short* miss) {
+                std::size_t nb_miss = self.sample_fast_block(r, x, m, miss);
+                self.record_samples(m);
+                self.record_fast(m - nb_miss);
+                return nb_miss;
+            },
+            [&self](Engine& e, UIntType r) {
+                return sample_slow(self, e, r);
+            });
+    }
+
+    // Generates a number from a random integer that missed the fast path.
+    //
+    // With a self-similar tail, outer hits start over from the table and
+    // accumulate the table extent in `offset`; they are recorded as rejected
+    // outer samples.
+    template<class Self, class RngType>
+    static RealType sample_slow(Self& self, RngType& g, UIntType r) {
+        RealType offset = 0.0;
+        while (true)
+        {
+            constexpr UIntType m_mask = (UIntType(1) << (W - N)) - 1;
+            UIntType u = r & m_mask;
+            auto i = std::size_t(r >> (W - N));
+            
+            // Should the outer distribution be sampled?
+            if (Category::HasOuter && u>=self.outer_switch()) {
+                if (Category::IsSelfSimilar) {
+                    offset += self.table_.x_last() - self.table_.x_first();
+                    self.record_outer(false);
+                }
+                else {
+                    RealType x;
+                    bool acceptance = self.sample_outer(g, x)
+                                   || !Category::HasRejection;
+                    self.record_outer(acceptance);
+                    if (acceptance)
+                        return x;
+                }
+            }
+            else {
+                // Otherwise it is a wedge, test y<f(x) for rejection sampling.
+                RealType v = generate_random_real<RealType, W>(g); // in [0,1)
+                RealType x = self.table_.x(i) + v*self.table_.width(i);
+                RealType y = to_real<RealType>(u)*self.table_[i].scaled_fsup;
+                bool acceptance = y < self.func_(x);
+                self.record_wedge(acceptance);
+                if (acceptance)
+                    return Category::IsSelfSimilar ? offset + x : x;
+            }
+            
+            // Rejected: start over.
+            r = generate_random_integer<UIntType, W>(g);
+            RealType x;
+            if (self.sample_fast(r, x)) {
+                self.record_fast(1);
+                return Category::IsSelfSimilar ? offset + x : x;
+            }
+        }
+    }
+
+    // Returns the abscissa of the origin of the table.
+    RealType origin() const {
+        return RealType(0);
+    }
+
 protected:
+    Table table_;
     static constexpr bool IsSymmetric = false;
 };
 
 
-template<typename RealType, std::size_t W, std::size_t N, class Category>
-class central : public Category
+template<typename RealType, std::size_t W, std::size_t N, class Category,
+         class Layout, class Storage, class Statistics>
+class central : public Category, public statistics_recorder<Statistics>
 {
 protected:
     using UIntType = typename Category::UIntType;
+    using Table = detail::table<RealType, UIntType, N, Layout, Storage>;
 
 public:
+    /// Returns a random number.
+    ///
     template<class RngType>
     RealType operator()(RngType& g) {
-        while (true)
-        {
-            // Generate a table index, a sign bit and a positive value from a
-            // single random number.
-            auto r = generate_random_integer<UIntType, W>(g);
-            // Mantissa is made of bits 0:(W-N-2).
-            constexpr UIntType m_mask = (UIntType(1) << (W - N - 1)) - 1;
-            UIntType u = r & m_mask;
-            // The table index is made of bits (W-N-1):(W-2).
-            constexpr std::size_t i_mask = (std::size_t(1) << N) - 1;
-            auto i = std::size_t(r >> (W - N - 1)) & i_mask;
-            // Sign is bit (W-1).
-            int s = r >> (W - 1) ? 1 : -1;
-            
-            const auto& d = this->data_[i];
-            // Note that the following test will also fail if 'u' is greater or
-            // equal to the outer switch value since all 'fratio' values are
-            // lower than the switch value.
-            if (u<d.scaled_fratio)
-                return s*(this->x_[i] + d.scaled_dx*u);
-            
-            // Should the outer distribution be sampled?
-            if (Category::HasOuter && u>=this->outer_switch()) {
-                RealType x;
-                bool acceptance = this->sample_outer(g, x);
-                if (!Category::HasRejection || acceptance)
-                    return s*x;
-            }
+        return sample(*this, g);
+    }
 
-            // Otherwise it is a wedge, test y<f(x) for rejection sampling.
-            RealType v = generate_random_real<RealType, W>(g); // v in [0,1)
-            RealType x = this->x_[i] + v*(this->x_[i+1] - this->x_[i]);
-            if ((u*d.scaled_fsup) < this->func_(x))
-                return s*x;
-        }
+    /// Returns a random number without modifying the distribution.
+    ///
+    /// This overload requires the `no_statistics` policy and a density
+    /// function and outer distribution callable on const objects.
+    ///
+    template<class RngType>
+    RealType operator()(RngType& g) const {
+        return sample(*this, g);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) {
+        generate_range(*this, first, last, g);
+    }
+
+    /// Fills a range with random numbers without modifying the distribution.
+    ///
+    /// This overload has the same requirements as the const `operator()`.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        generate_range(*this, first, last, g);
     }
 
     template<typename=void>
     RealType min() const {
-        auto mm = std::minmax(this->x_.front(), this->x_.back());
+        auto mm = std::minmax(table_.x_first(), table_.x_last());
         RealType m = std::min(mm.first, -mm.second);
         if (Category::HasOuter) {
             RealType t = std::min(this->outer_min(), -this->outer_max());
@@ -287,7 +511,7 @@ public:
     
     template<typename=void>
     RealType max() const {
-        auto mm = std::minmax(this->x_.front(), this->x_.back());
+        auto mm = std::minmax(table_.x_first(), table_.x_last());
         RealType m = std::max(-mm.first, mm.second);
         if (Category::HasOuter) {
             RealType t = std::max(this->outer_max(), -this->outer_min());
@@ -300,60 +524,187 @@ public:
 protected:
     using Category::Category;
 
-protected:
-    static constexpr bool IsSymmetric = true;
-};
+    // Attempts to generate a number from the random integer using the fast
+    // path only.
+    //
+    // The candidate value is computed unconditionally and is only valid if
+    // true is returned.
+    bool sample_fast(UIntType r, RealType& x) const {
+        // Mantissa is made of bits 0:(W-N-2).
+        constexpr UIntType m_mask = (UIntType(1) << (W - N - 1)) - 1;
+        UIntType u = r & m_mask;
+        // The table index is made of bits (W-N-1):(W-2).
+        constexpr std::size_t i_mask = (std::size_t(1) << N) - 1;
+        auto i = std::size_t(r >> (W - N - 1)) & i_mask;
+        // Sign is bit (W-1).
+        RealType s = r >> (W - 1) ? RealType(1) : RealType(-1);
+        
+        const auto& d = table_[i];
+        x = s*(table_.x(i) + d.scaled_dx*to_real<RealType>(u));
+        // Note that the following test will also fail if 'u' is greater or
+        // equal to the outer switch value since all 'fratio' values are
+        // lower than the switch value.
+        return u<d.scaled_fratio;
+    }
 
+    // Attempts the fast path on a block of random integers.
+    //
+    // The indices of the random integers which missed the fast path are
+    // written to `miss` and their number is returned.
+    //
+    // When available, a vectorized kernel processes the bulk of the block and
+    // the remainder is processed with the scalar fast path.
+    std::size_t sample_fast_block(const UIntType* r, RealType* x,
+                                  std::size_t m, unsigned short* miss) const {
+        using Kernel = central_kernel<RealType, UIntType, W, N>;
+        std::size_t nb_miss = 0;
+        std::size_t k = Kernel::run(r, x, m, miss, nb_miss,
+                                    table_.x_data(), Table::x_stride,
+                                    &table_[0].scaled_fratio,
+                                    &table_[0].scaled_dx,
+                                    sizeof(table_[0]));
+        for (; k!=m; ++k) {
+            bool hit = sample_fast(r[k], x[k]);
+            miss[nb_miss] = static_cast<unsigned short>(k);
+            nb_miss += hit ? 0 : 1;
+        }
+        return nb_miss;
+    }
 
-template<typename RealType, std::size_t W, std::size_t N, class Category>
-class symmetric : public Category
-{
-protected:
-    using UIntType = typename Category::UIntType;
+    // Generates a number.
+    //
+    // The sampling functions are static so that they can be shared by the
+    // const and non-const members; `Self` is the possibly const-qualified
+    // type of the distribution.
+    template<class Self, class RngType>
+    static RealType sample(Self& self, RngType& g) {
+        auto&& h = self.engine(g);
+        self.record_samples(1);
+        auto r = generate_random_integer<UIntType, W>(h);
+        RealType x;
+        if (self.sample_fast(r, x)) {
+            self.record_fast(1);
+            return x;
+        }
+        return sample_slow(self, h, r);
+    }
 
-public:
-    template<class RngType>
-    RealType operator()(RngType& g) {
+    // Fills a range with numbers generated block-wise.
+    template<class Self, class ForwardIt, class RngType>
+    static void generate_range(Self& self, ForwardIt first, ForwardIt last,
+                               RngType& g) {
+        auto&& h = self.engine(g);
+        using Engine = typename std::remove_reference<decltype(h)>::type;
+        detail::generate_blocks<RealType, UIntType, W>(first, last, h,
+            [&self](const UIntType* r, RealType* x, std::size_t m,
+                    unsigned short* miss) {
+                std::size_t nb_miss = self.sample_fast_block(r, x, m, miss);
+                self.record_samples(m);
+                self.record_fast(m - nb_miss);
+                return nb_miss;
+            },
+            [&self](Engine& e, UIntType r) {
+                return sample_slow(self, e, r);
+            });
+    }
+
+    // Generates a number from a random integer that missed the fast path.
+    template<class Self, class RngType>
+    static RealType sample_slow(Self& self, RngType& g, UIntType r) {
         while (true)
         {
-            // Generate a table index, a sign bit and a positive value from a
-            // single random number.
-            auto r = generate_random_integer<UIntType, W>(g);
-            // Mantissa is made of bits 0:(W-N-2).
             constexpr UIntType m_mask = (UIntType(1) << (W - N - 1)) - 1;
             UIntType u = r & m_mask;
-            // The table index is made of bits (W-N-1):(W-2).
             constexpr std::size_t i_mask = (std::size_t(1) << N) - 1;
             auto i = std::size_t(r >> (W - N - 1)) & i_mask;
-            // Sign is bit (W-1).
             int s = r >> (W - 1) ? 1 : -1;
             
-            const auto& d = this->data_[i];
-            // Note that the following test will also fail if 'u' is greater or
-            // equal to the outer switch value since all 'fratio' values are
-            // lower than the switch value.
-            if (u<d.scaled_fratio)
-                return x_origin_ + s*(this->x_[i] + d.scaled_dx*u);
-            
             // Should the outer distribution be sampled?
-            if (Category::HasOuter && u>=this->outer_switch()) {
+            if (Category::HasOuter && u>=self.outer_switch()) {
                 RealType x;
-                bool acceptance = this->sample_outer(g, x);
-                if (!Category::HasRejection || acceptance)
-                    return x_origin_ + s*(x - x_origin_);
+                bool acceptance = self.sample_outer(g, x)
+                               || !Category::HasRejection;
+                self.record_outer(acceptance);
+                if (acceptance)
+                    return s*x;
+            }
+            else {
+                // Otherwise it is a wedge, test y<f(x) for rejection sampling.
+                RealType v = generate_random_real<RealType, W>(g); // in [0,1)
+                RealType x = self.table_.x(i) + v*self.table_.width(i);
+                RealType y = to_real<RealType>(u)*self.table_[i].scaled_fsup;
+                bool acceptance = y < self.func_(x);
+                self.record_wedge(acceptance);
+                if (acceptance)
+                    return s*x;
+            }
+            
+            // Rejected: start over.
+            r = generate_random_integer<UIntType, W>(g);
+            RealType x;
+            if (self.sample_fast(r, x)) {
+                self.record_fast(1);
+                return x;
             }
-
-            // Otherwise it is a wedge, test y<f(x) for rejection sampling.
-            RealType v = generate_random_real<RealType, W>(g); // v in [0,1)
-            RealType x = this->x_[i] + v*(this->x_[i+1] - this->x_[i]);
-            if ((u*d.scaled_fsup) < this->func_(x + x_origin_))
-                return x_origin_ + s*x;
         }
     }
 
+    // Returns the abscissa of the origin of the table.
+    RealType origin() const {
+        return RealType(0);
+    }
+
+protected:
+    Table table_;
+    static constexpr bool IsSymmetric = true;
+};
+
+
+template<typename RealType, std::size_t W, std::size_t N, class Category,
+         class Layout, class Storage, class Statistics>
+class symmetric : public Category, public statistics_recorder<Statistics>
+{
+protected:
+    using UIntType = typename Category::UIntType;
+    using Table = detail::table<RealType, UIntType, N, Layout, Storage>;
+
+public:
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    RealType operator()(RngType& g) {
+        return sample(*this, g);
+    }
+
+    /// Returns a random number without modifying the distribution.
+    ///
+    /// This overload requires the `no_statistics` policy and a density
+    /// function and outer distribution callable on const objects.
+    ///
+    template<class RngType>
+    RealType operator()(RngType& g) const {
+        return sample(*this, g);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) {
+        generate_range(*this, first, last, g);
+    }
+
+    /// Fills a range with random numbers without modifying the distribution.
+    ///
+    /// This overload has the same requirements as the const `operator()`.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        generate_range(*this, first, last, g);
+    }
+
     template<typename=void>
     RealType min() const {
-        auto mm = std::minmax(this->x_.front(), this->x_.back());
+        auto mm = std::minmax(table_.x_first(), table_.x_last());
         RealType m = std::min(x_origin_ + mm.first, x_origin_ - mm.second);
         if (Category::HasOuter) {
             RealType t = std::min(this->outer_min(),
@@ -366,7 +717,7 @@ public:
     
     template<typename=void>
     RealType max() const {
-        auto mm = std::minmax(this->x_.front(), this->x_.back());
+        auto mm = std::minmax(table_.x_first(), table_.x_last());
         RealType m = std::max(x_origin_ - mm.first, x_origin_ + mm.second);
         if (Category::HasOuter) {
             RealType t = std::max(this->outer_max(),
@@ -383,7 +734,129 @@ protected:
     template<typename... Args>
     symmetric(RealType x0, Args... args): Category(args...), x_origin_(x0) {}
 
+    // Attempts to generate a number from the random integer using the fast
+    // path only.
+    //
+    // The candidate value is computed unconditionally and is only valid if
+    // true is returned.
+    bool sample_fast(UIntType r, RealType& x) const {
+        // Mantissa is made of bits 0:(W-N-2).
+        constexpr UIntType m_mask = (UIntType(1) << (W - N - 1)) - 1;
+        UIntType u = r & m_mask;
+        // The table index is made of bits (W-N-1):(W-2).
+        constexpr std::size_t i_mask = (std::size_t(1) << N) - 1;
+        auto i = std::size_t(r >> (W - N - 1)) & i_mask;
+        // Sign is bit (W-1).
+        RealType s = r >> (W - 1) ? RealType(1) : RealType(-1);
+        
+        const auto& d = table_[i];
+        x = x_origin_ + s*(table_.x(i) + d.scaled_dx*to_real<RealType>(u));
+        // Note that the following test will also fail if 'u' is greater or
+        // equal to the outer switch value since all 'fratio' values are
+        // lower than the switch value.
+        return u<d.scaled_fratio;
+    }
+
+    // Attempts the fast path on a block of random integers.
+    //
+    // The indices of the random integers which missed the fast path are
+    // written to `miss` and their number is returned.
+    std::size_t sample_fast_block(const UIntType* r, RealType* x,
+                                  std::size_t m, unsigned short* miss) const {
+        std::size_t nb_miss = 0;
+        for (std::size_t k=0; k!=m; ++k) {
+            bool hit = sample_fast(r[k], x[k]);
+            miss[nb_miss] = static_cast<unsigned short>(k);
+            nb_miss += hit ? 0 : 1;
+        }
+        return nb_miss;
+    }
+
+    // Generates a number.
+    //
+    // The sampling functions are static so that they can be shared by the
+    // const and non-const members; `Self` is the possibly const-qualified
+    // type of the distribution.
+    template<class Self, class RngType>
+    static RealType sample(Self& self, RngType& g) {
+        auto&& h = self.engine(g);
+        self.record_samples(1);
+        auto r = generate_random_integer<UIntType, W>(h);
+        RealType x;
+        if (self.sample_fast(r, x)) {
+            self.record_fast(1);
+            return x;
+        }
+        return sample_slow(self, h, r);
+    }
+
+    // Fills a range with numbers generated block-wise.
+    template<class Self, class ForwardIt, class RngType>
+    static void generate_range(Self& self, ForwardIt first, ForwardIt last,
+                               RngType& g) {
+        auto&& h = self.engine(g);
+        using Engine = typename std::remove_reference<decltype(h)>::type;
+        detail::generate_blocks<RealType, UIntType, W>(first, last, h,
+            [&self](const UIntType* r, RealType* x, std::size_t m,
+                    unsigned short* miss) {
+                std::size_t nb_miss = self.sample_fast_block(r, x, m, miss);
+                self.record_samples(m);
+                self.record_fast(m - nb_miss);
+                return nb_miss;
+            },
+            [&self](Engine& e, UIntType r) {
+                return sample_slow(self, e, r);
+            });
+    }
+
+    // Generates a number from a random integer that missed the fast path.
+    template<class Self, class RngType>
+    static RealType sample_slow(Self& self, RngType& g, UIntType r) {
+        while (true)
+        {
+            constexpr UIntType m_mask = (UIntType(1) << (W - N - 1)) - 1;
+            UIntType u = r & m_mask;
+            constexpr std::size_t i_mask = (std::size_t(1) << N) - 1;
+            auto i = std::size_t(r >> (W - N - 1)) & i_mask;
+            int s = r >> (W - 1) ? 1 : -1;
+            
+            // Should the outer distribution be sampled?
+            if (Category::HasOuter && u>=self.outer_switch()) {
+                RealType x;
+                bool acceptance = self.sample_outer(g, x)
+                               || !Category::HasRejection;
+                self.record_outer(acceptance);
+                if (acceptance)
+                    return self.x_origin_ + s*(x - self.x_origin_);
+            }
+            else {
+                // Otherwise it is a wedge, test y<f(x) for rejection sampling.
+                RealType v = generate_random_real<RealType, W>(g); // in [0,1)
+                RealType x = self.table_.x(i) + v*self.table_.width(i);
+                RealType y = to_real<RealType>(u)*self.table_[i].scaled_fsup;
+                bool acceptance = y < self.func_(x + self.x_origin_);
+                self.record_wedge(acceptance);
+                if (acceptance)
+                    return self.x_origin_ + s*x;
+            }
+            
+            // Rejected: start over.
+            r = generate_random_integer<UIntType, W>(g);
+            RealType x;
+            if (self.sample_fast(r, x)) {
+                self.record_fast(1);
+                return x;
+            }
+        }
+    }
+
+    // Returns the abscissa of the origin of the table.
+    RealType origin() const {
+        return x_origin_;
+    }
+
 protected:
+    Table table_;
     RealType x_origin_;
     static constexpr bool IsSymmetric = true;
 };
@@ -391,6 +864,19 @@ protected:
 
 template<typename RealType, std::size_t W, std::size_t N, class Shape>
 struct builder : public Shape {
+public:
+    /// Returns the size in bytes of the lookup tables.
+    ///
+    static constexpr std::size_t table_footprint() {
+        return Shape::Table::footprint;
+    }
+
+    /// Returns true if copies of the distribution share its lookup tables.
+    ///
+    static constexpr bool shares_tables() {
+        return Shape::Table::shared;
+    }
+
 private:
     using typename Shape::UIntType;
 
@@ -411,9 +897,10 @@ private:
     using Shape::outer_max;
 
 private:
-    using Shape::x_;
-    using Shape::data_;
+    using Shape::table_;
 
+    template<class Distribution>
+    friend class etf::truncated_distribution;
 };
 
 
@@ -429,22 +916,23 @@ void builder<RealType, W, N, Shape>::build(RealType x_origin,
     // Bit-width of the sign, if any.
     constexpr std::size_t S = builder::IsSymmetric ? 1 : 0;
 
-    // Resize tables and assign x coordinates.
+    // Resize tables and assign x coordinates, making them relative to the
+    // origin.
     const std::size_t n = std::size_t(1) << N;
-    this->data_.resize(n);
-    this->x_.assign(x_first, x_last);
-    if (this->x_.size()!=(n + 1))
-        throw invalid_table_size();
-    
-    // Translate x to make it relative to the origin if necessary.
-    if (x_origin!=RealType(0.0)) {
-        for (auto& x: this->x_)
-            x -= x_origin;
+    auto& table = this->table_;
+    table.resize();
+    std::size_t nb_x = 0;
+    for (; x_first!=x_last; ++x_first, ++nb_x) {
+        if (nb_x>n)
+            throw invalid_table_size();
+        table.set_x(nb_x, *x_first - x_origin);
     }
+    if (nb_x!=(n + 1))
+        throw invalid_table_size();
 
     // Assign fsup but do not perform any scaling for now.
     for (std::size_t i=0; i!=n; ++i)
-       this->data_[i].scaled_fsup = *fsup_first++; 
+       table[i].scaled_fsup = *fsup_first++; 
 
     // Compute the outer switch, i.e. an integer threshold such that when
     // drawing a random integer r, the probability:
@@ -454,8 +942,7 @@ void builder<RealType, W, N, Shape>::build(RealType x_origin,
     if (builder::HasOuter) {
         RealType upper_quadrature_area = 0.0;
         for (std::size_t i=0; i!=n; ++i) {
-            upper_quadrature_area +=
-                (this->x_[i+1] - this->x_[i])*this->data_[i].scaled_fsup;
+            upper_quadrature_area += table.width(i)*table[i].scaled_fsup;
         }
         outer_switch = static_cast<UIntType>(
             std::round(RealType(UIntType(1) << (W - N - S)) *
@@ -467,15 +954,14 @@ void builder<RealType, W, N, Shape>::build(RealType x_origin,
 
     // Compute the tables.
     for (std::size_t i=0; i!=n; ++i) {
-        RealType fratio = (*finf_first++)/this->data_[i].scaled_fsup;
+        auto& d = table[i];
+        RealType fratio = (*finf_first++)/d.scaled_fsup;
         if (fratio>=RealType(0.5)) // will we loose at most 1 bit of accuracy?
-            this->data_[i].scaled_fratio =
-                static_cast<UIntType>(fratio*outer_switch);
+            d.scaled_fratio = static_cast<UIntType>(fratio*outer_switch);
         else // otherwise, force wedge sampling to ensure high quality samples
-            this->data_[i].scaled_fratio = 0;
-        this->data_[i].scaled_fsup /= outer_switch;
-        this->data_[i].scaled_dx = (this->x_[i+1] - this->x_[i])/
-                                   this->data_[i].scaled_fratio;
+            d.scaled_fratio = 0;
+        d.scaled_fsup /= outer_switch;
+        d.scaled_dx = table.width(i)/d.scaled_fratio;
     }
 }
 
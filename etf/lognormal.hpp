@@ -0,0 +1,151 @@
+#ifndef ETF_LOGNORMAL_HPP
+#define ETF_LOGNORMAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "normal.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Lognormal distribution.
+///
+/// This distribution has the same interface as
+/// `std::lognormal_distribution`. Variates are computed as `exp(m + s*z)`
+/// where `z` is generated with the standard normal ETF distribution of
+/// `normal_distribution`, whose tables are shared with it.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class lognormal_distribution
+{
+public:
+    using result_type = RealType;
+
+    /// Distribution parameters.
+    ///
+    class param_type
+    {
+    public:
+        using distribution_type = lognormal_distribution;
+
+        explicit param_type(RealType m=0.0, RealType s=1.0)
+        : m_(m), s_(s) {}
+
+        RealType m() const { return m_; }
+
+        RealType s() const { return s_; }
+
+        friend bool operator==(const param_type& a, const param_type& b) {
+            return a.m_==b.m_ && a.s_==b.s_;
+        }
+
+        friend bool operator!=(const param_type& a, const param_type& b) {
+            return !(a==b);
+        }
+
+    private:
+        RealType m_;
+        RealType s_;
+    };
+
+    lognormal_distribution() : lognormal_distribution(0.0) {}
+
+    explicit lognormal_distribution(RealType m, RealType s=1.0)
+    : lognormal_distribution(param_type(m, s)) {}
+
+    explicit lognormal_distribution(const param_type& params)
+    : params_(params),
+      z_(detail::standard_normal_tables<RealType, W, N>()) {}
+
+    void reset() {}
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        return (*this)(g, params_);
+    }
+
+    /// Returns a random number generated with the specified parameters.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g, const param_type& params) const {
+        return std::exp(params.m() + params.s()*z_(g));
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        z_.generate(first, last, g);
+        for (; first!=last; ++first)
+            *first = std::exp(params_.m() + params_.s()*(*first));
+    }
+
+    RealType m() const { return params_.m(); }
+
+    RealType s() const { return params_.s(); }
+
+    param_type param() const { return params_; }
+
+    void param(const param_type& params) { params_ = params; }
+
+    result_type min() const {
+        return RealType(0.0);
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    friend bool operator==(const lognormal_distribution& a,
+                           const lognormal_distribution& b) {
+        return a.params_==b.params_;
+    }
+
+    friend bool operator!=(const lognormal_distribution& a,
+                           const lognormal_distribution& b) {
+        return !(a==b);
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const lognormal_distribution& d) {
+        auto flags = os.flags(std::ios_base::scientific);
+        auto precision = os.precision(
+            std::numeric_limits<RealType>::max_digits10);
+        os << d.m() << os.widen(' ') << d.s();
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               lognormal_distribution& d) {
+        auto flags = is.flags(std::ios_base::dec | std::ios_base::skipws);
+        RealType m;
+        RealType s;
+        if (is >> m >> s)
+            d.param(param_type(m, s));
+        is.flags(flags);
+        return is;
+    }
+
+private:
+    param_type params_;
+    detail::standard_normal<RealType, W, N> z_;
+};
+
+} // namespace etf
+
+#endif // ETF_LOGNORMAL_HPP
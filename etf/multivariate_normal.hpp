@@ -0,0 +1,258 @@
+#ifndef ETF_MULTIVARIATE_NORMAL_HPP
+#define ETF_MULTIVARIATE_NORMAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "normal.hpp"
+#include "simd.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Storage order of the vectors generated by
+/// `multivariate_normal_distribution::generate()`.
+///
+enum class matrix_layout
+{
+    row_major,      ///< Each vector is contiguous.
+    column_major    ///< Each component is contiguous.
+};
+
+
+namespace detail {
+
+// Number of vectors transformed at a time by bulk generation.
+//
+// The accumulators of a block fit in vector registers and the standard normal
+// variates of a block of 256-dimensional vectors fit in the L1 cache.
+constexpr std::size_t multivariate_block_size = 16;
+
+} // namespace detail
+
+
+/// Multivariate normal distribution.
+///
+/// Variates are computed as `m + L*z`, where `m` is the mean vector, `L` the
+/// lower triangular Cholesky factor of the covariance matrix and `z` a vector
+/// of standard normal variates generated with the standard normal ETF
+/// distribution of `normal_distribution`, whose tables are shared with it.
+///
+/// The sampling members are `const` so that a single object may be used
+/// concurrently by several threads, each passing its own generator.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class multivariate_normal_distribution
+{
+private:
+    static constexpr std::size_t B = detail::multivariate_block_size;
+
+public:
+    using result_type = RealType;
+
+    /// Creates a distribution from its mean and covariance matrix.
+    ///
+    /// The dimension is the length of the [`mean_first`, `mean_last`) range.
+    /// The covariance matrix is read in row-major order from `cov_first`; only
+    /// its lower triangle is used. An `std::invalid_argument` exception is
+    /// thrown if the dimension is 0 or if the matrix is not positive definite.
+    ///
+    template<class InputIt1, class InputIt2>
+    multivariate_normal_distribution(InputIt1 mean_first, InputIt1 mean_last,
+                                     InputIt2 cov_first)
+    : mean_(mean_first, mean_last),
+      z_(detail::standard_normal_tables<RealType, W, N>()) {
+        const std::size_t d = mean_.size();
+        if (d==0)
+            throw std::invalid_argument("empty mean vector");
+
+        // Packed lower triangle, row i starting at offset i*(i + 1)/2.
+        l_.resize(d*(d + 1)/2);
+        for (std::size_t i=0; i!=d; ++i) {
+            for (std::size_t j=0; j!=d; ++j, ++cov_first) {
+                if (j<=i)
+                    l_[i*(i + 1)/2 + j] = static_cast<RealType>(*cov_first);
+            }
+        }
+        factorize();
+    }
+
+    void reset() {}
+
+    /// Returns the dimension of the vectors.
+    ///
+    std::size_t dimension() const { return mean_.size(); }
+
+    /// Returns the mean vector.
+    ///
+    const std::vector<RealType>& mean() const { return mean_; }
+
+    /// Returns element (`i`, `j`) of the Cholesky factor of the covariance
+    /// matrix.
+    ///
+    RealType cholesky_factor(std::size_t i, std::size_t j) const {
+        return j<=i ? l_[i*(i + 1)/2 + j] : RealType(0);
+    }
+
+    /// Writes a random vector to the range starting at `first`.
+    ///
+    template<class OutputIt, class RngType>
+    OutputIt operator()(RngType& g, OutputIt first) const {
+        const std::size_t d = mean_.size();
+        std::vector<RealType> z(d);
+        z_.generate(z.begin(), z.end(), g);
+        const RealType* l = l_.data();
+        for (std::size_t i=0; i!=d; ++i, ++first) {
+            RealType y = RealType(0);
+            for (std::size_t k=0; k<=i; ++k)
+                y += l[k]*z[k];
+            l += i + 1;
+            *first = mean_[i] + y;
+        }
+        return first;
+    }
+
+    /// Fills a range with random vectors.
+    ///
+    /// The length of the range must be a multiple of the dimension. Vectors
+    /// are stored one after the other with `matrix_layout::row_major`; with
+    /// `matrix_layout::column_major`, component `i` of vector `v` is stored at
+    /// `first[i*count + v]`, where `count` is the number of vectors.
+    ///
+    /// Vectors are generated by blocks of 16 in a single pass: the standard
+    /// normal variates of a block are generated in bulk, then transformed by a
+    /// triangular matrix product whose inner loop runs over the vectors of the
+    /// block (see `<etf/simd.hpp>`), and the results are written to the
+    /// range.
+    ///
+    template<class RandomIt, class RngType>
+    void generate(RandomIt first, RandomIt last, RngType& g,
+                  matrix_layout layout=matrix_layout::row_major) const {
+        const std::size_t d = mean_.size();
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if (n%d!=0)
+            throw std::invalid_argument(
+                "range length is not a multiple of the dimension");
+        const std::size_t count = n/d;
+
+        // Standard normal variates of a block, z[k*B + v] being component k
+        // of vector v.
+        std::vector<RealType> z(d*B);
+        for (std::size_t v0=0; v0<count; v0+=B) {
+            const std::size_t m = count - v0<B ? count - v0 : B;
+            z_.generate(z.begin(), z.begin() + d*m, g);
+            // A partial block is left-aligned within each row.
+            if (m!=B)
+                spread(z.data(), m);
+
+            // Rows of the Cholesky factor are processed by pairs.
+            for (std::size_t i=0; i<d; i+=2) {
+                const RealType* l0 = &l_[i*(i + 1)/2];
+                const bool pair = i + 1<d;
+                const RealType* l1 = pair ? l0 + i + 1 : l0;
+                RealType y0[B];
+                RealType y1[B];
+                detail::row_pair_kernel<RealType, B>::run(
+                    l0, l1, i + 1, z.data(), y0, y1);
+                store_row(first, layout, count, i, v0, m, y0);
+                if (pair) {
+                    // Diagonal element of the second row.
+                    const RealType c = l1[i + 1];
+                    const RealType* zi = &z[(i + 1)*B];
+                    for (std::size_t v=0; v!=B; ++v)
+                        y1[v] += c*zi[v];
+                    store_row(first, layout, count, i + 1, v0, m, y1);
+                }
+            }
+        }
+    }
+
+    result_type min() const {
+        return std::numeric_limits<RealType>::lowest();
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    friend bool operator==(const multivariate_normal_distribution& a,
+                           const multivariate_normal_distribution& b) {
+        return a.mean_==b.mean_ && a.l_==b.l_;
+    }
+
+    friend bool operator!=(const multivariate_normal_distribution& a,
+                           const multivariate_normal_distribution& b) {
+        return !(a==b);
+    }
+
+private:
+    // Replaces the packed lower triangle of the covariance matrix by its
+    // Cholesky factor.
+    void factorize() {
+        const std::size_t d = mean_.size();
+        for (std::size_t i=0; i!=d; ++i) {
+            RealType* li = &l_[i*(i + 1)/2];
+            for (std::size_t j=0; j<=i; ++j) {
+                const RealType* lj = &l_[j*(j + 1)/2];
+                RealType s = li[j];
+                for (std::size_t k=0; k!=j; ++k)
+                    s -= li[k]*lj[k];
+                if (j<i) {
+                    li[j] = s/lj[j];
+                }
+                else {
+                    if (!(s>RealType(0)))
+                        throw std::invalid_argument(
+                            "covariance matrix is not positive definite");
+                    li[j] = std::sqrt(s);
+                }
+            }
+        }
+    }
+
+    // Moves the first `m` variates of each row of a block to their position
+    // in the row, given that the rows were generated contiguously.
+    void spread(RealType* z, std::size_t m) const {
+        for (std::size_t k=mean_.size(); k--!=0;) {
+            for (std::size_t v=m; v--!=0;)
+                z[k*B + v] = z[k*m + v];
+        }
+    }
+
+    // Writes component `i` of vectors `v0` to `v0 + m - 1`, offset by the
+    // mean, to the output range.
+    template<class RandomIt>
+    void store_row(RandomIt first, matrix_layout layout, std::size_t count,
+                   std::size_t i, std::size_t v0, std::size_t m,
+                   const RealType* y) const {
+        using difference_type =
+            typename std::iterator_traits<RandomIt>::difference_type;
+
+        const std::size_t d = mean_.size();
+        const RealType mu = mean_[i];
+        if (layout==matrix_layout::row_major) {
+            for (std::size_t v=0; v!=m; ++v)
+                first[static_cast<difference_type>((v0 + v)*d + i)] =
+                    mu + y[v];
+        }
+        else {
+            for (std::size_t v=0; v!=m; ++v)
+                first[static_cast<difference_type>(i*count + v0 + v)] =
+                    mu + y[v];
+        }
+    }
+
+    std::vector<RealType> mean_;
+    std::vector<RealType> l_;
+    detail::standard_normal<RealType, W, N> z_;
+};
+
+} // namespace etf
+
+#endif // ETF_MULTIVARIATE_NORMAL_HPP
@@ -0,0 +1,250 @@
+#ifndef ETF_NORMAL_HPP
+#define ETF_NORMAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "distribution.hpp"
+#include "exceptions.hpp"
+#include "standard_partitions.hpp"
+#include "table.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Non-normalized probability density function of the standard normal
+// distribution.
+template<typename RealType>
+struct normal_pdf
+{
+    RealType operator()(RealType x) const {
+        return std::exp(RealType(-0.5)*x*x);
+    }
+};
+
+
+// Standard normal ETF distribution with shared tables.
+template<typename RealType, std::size_t W, std::size_t N>
+using standard_normal =
+    central_distribution<RealType, W, N, normal_pdf<RealType>,
+                         normal_tail_distribution<RealType, W>, void,
+                         split_layout, shared_storage>;
+
+
+// Builds a standard normal ETF distribution from a partition of [0, xtail].
+template<typename RealType, std::size_t W, std::size_t N, class Partition>
+standard_normal<RealType, W, N> make_standard_normal(
+    const Partition& p, RealType xtail, RealType tail_area) {
+    return make_central_distribution<RealType, W, N, split_layout,
+                                     shared_storage>(
+        p.x.begin(), p.x.end(), p.finf.begin(), p.fsup.begin(),
+        normal_pdf<RealType>(), normal_tail_distribution<RealType, W>(xtail),
+        tail_area);
+}
+
+
+// The partition is computed at run time.
+template<typename RealType, std::size_t W, std::size_t N>
+standard_normal<RealType, W, N> make_standard_normal(std::false_type) {
+    normal_pdf<RealType> pdf;
+    const std::size_t n = std::size_t(1) << N;
+    const RealType xtail = normal_xtail<RealType>(W, N);
+    const RealType sqrt_pi_over_two = RealType(1.2533141373155001);
+    const RealType tail_area =
+        sqrt_pi_over_two*std::erfc(xtail/std::sqrt(RealType(2.0)));
+
+    const RealType rel_tol = std::numeric_limits<RealType>::epsilon()
+                           * RealType(1e4);
+    auto x_guess = trapezoidal_rule_prepartition(pdf, RealType(0.0), xtail,
+                                                 n);
+    auto dpdf = [](RealType x) { return -x*std::exp(RealType(-0.5)*x*x); };
+    auto p = newton_partition_monotonic(pdf, dpdf,
+                                        x_guess.begin(), x_guess.end(),
+                                        rel_tol);
+    if (p.x.empty())
+        throw partition_convergence_error();
+
+    return make_standard_normal<RealType, W, N>(p, xtail, tail_area);
+}
+
+
+#if __cplusplus >= 201703L
+// The partition is computed at compile time.
+template<typename RealType, std::size_t W, std::size_t N>
+standard_normal<RealType, W, N> make_standard_normal(std::true_type) {
+    using Partition = static_normal_partition<RealType, W, N>;
+    return make_standard_normal<RealType, W, N>(
+        Partition::partition, Partition::xtail, Partition::tail_area);
+}
+#endif
+
+
+template<typename RealType, std::size_t W, std::size_t N>
+standard_normal<RealType, W, N> make_standard_normal() {
+    return make_standard_normal<RealType, W, N>(use_static_partition<N>());
+}
+
+
+// Returns a standard normal ETF distribution.
+//
+// The tables are computed on the first call and are then shared by all
+// copies of the returned object.
+template<typename RealType, std::size_t W, std::size_t N>
+const standard_normal<RealType, W, N>& standard_normal_tables() {
+    static const standard_normal<RealType, W, N> d =
+        make_standard_normal<RealType, W, N>();
+    return d;
+}
+
+} // namespace detail
+
+
+/// Normal distribution.
+///
+/// This distribution has the same interface as `std::normal_distribution`.
+/// Standard normal variates are generated with a central ETF distribution
+/// whose tail is sampled with Marsaglia's algorithm.
+///
+/// The tables only depend on the template parameters: they are computed once
+/// (at compile time in C++17 if `N` does not exceed `static_partition_max_n`)
+/// and are shared by all distribution objects, which are therefore cheap to
+/// construct and copy. Variates can be
+/// generated concurrently from a single object by several threads, each
+/// passing its own generator.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class normal_distribution
+{
+public:
+    using result_type = RealType;
+
+    /// Distribution parameters.
+    ///
+    class param_type
+    {
+    public:
+        using distribution_type = normal_distribution;
+
+        explicit param_type(RealType mean=0.0, RealType stddev=1.0)
+        : mean_(mean), stddev_(stddev) {}
+
+        RealType mean() const { return mean_; }
+
+        RealType stddev() const { return stddev_; }
+
+        friend bool operator==(const param_type& a, const param_type& b) {
+            return a.mean_==b.mean_ && a.stddev_==b.stddev_;
+        }
+
+        friend bool operator!=(const param_type& a, const param_type& b) {
+            return !(a==b);
+        }
+
+    private:
+        RealType mean_;
+        RealType stddev_;
+    };
+
+    normal_distribution() : normal_distribution(0.0) {}
+
+    explicit normal_distribution(RealType mean, RealType stddev=1.0)
+    : normal_distribution(param_type(mean, stddev)) {}
+
+    explicit normal_distribution(const param_type& params)
+    : params_(params),
+      z_(detail::standard_normal_tables<RealType, W, N>()) {}
+
+    void reset() {}
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        return (*this)(g, params_);
+    }
+
+    /// Returns a random number generated with the specified parameters.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g, const param_type& params) const {
+        return params.mean() + params.stddev()*z_(g);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        z_.generate(first, last, g);
+        for (; first!=last; ++first)
+            *first = params_.mean() + params_.stddev()*(*first);
+    }
+
+    RealType mean() const { return params_.mean(); }
+
+    RealType stddev() const { return params_.stddev(); }
+
+    param_type param() const { return params_; }
+
+    void param(const param_type& params) { params_ = params; }
+
+    result_type min() const {
+        return std::numeric_limits<RealType>::lowest();
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    friend bool operator==(const normal_distribution& a,
+                           const normal_distribution& b) {
+        return a.params_==b.params_;
+    }
+
+    friend bool operator!=(const normal_distribution& a,
+                           const normal_distribution& b) {
+        return !(a==b);
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const normal_distribution& d) {
+        auto flags = os.flags(std::ios_base::scientific);
+        auto precision = os.precision(
+            std::numeric_limits<RealType>::max_digits10);
+        os << d.mean() << os.widen(' ') << d.stddev();
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               normal_distribution& d) {
+        auto flags = is.flags(std::ios_base::dec | std::ios_base::skipws);
+        RealType mean;
+        RealType stddev;
+        if (is >> mean >> stddev)
+            d.param(param_type(mean, stddev));
+        is.flags(flags);
+        return is;
+    }
+
+private:
+    param_type params_;
+    detail::standard_normal<RealType, W, N> z_;
+};
+
+} // namespace etf
+
+#endif // ETF_NORMAL_HPP
@@ -0,0 +1,135 @@
+#ifndef ETF_PARALLEL_HPP
+#define ETF_PARALLEL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Check whether a random number generator provides a `jump()` member.
+template<typename RngType, typename=void>
+struct has_jump : std::false_type {};
+
+template<typename RngType>
+struct has_jump<RngType, decltype(void(std::declval<RngType&>().jump()))>
+    : std::true_type {};
+
+} // namespace detail
+
+
+/// Default number of variates per chunk for `parallel_generate`.
+///
+constexpr std::size_t default_parallel_chunk_size = std::size_t(1) << 16;
+
+
+/// Fills a range with random numbers using several threads.
+///
+/// The range is split into chunks of `chunk_size` variates (except for the
+/// last chunk, which may be shorter). Chunk `c` is generated with its own
+/// copy of the random number generator advanced by `c` calls to `jump()`, so
+/// that the result only depends on the state of `rng` and on the chunk size,
+/// and not on the number of threads or on their scheduling.
+///
+/// Chunks are handed out dynamically to `nb_threads` worker threads, or to as
+/// many threads as there are hardware threads if `nb_threads` is 0. Each
+/// chunk is generated with a fresh copy of the distribution so that the state
+/// of the outer distribution, if any, does not carry over between chunks.
+///
+/// On return, `rng` is advanced by as many calls to `jump()` as there were
+/// chunks, so that subsequent calls generate non-overlapping sequences.
+///
+/// If an exception is thrown by a worker thread, the remaining chunks are
+/// abandoned and the exception is rethrown once all threads have completed.
+///
+template<class Dist, class RandomIt, class RngType>
+void parallel_generate(const Dist& dist,
+                       RandomIt first,
+                       RandomIt last,
+                       RngType& rng,
+                       unsigned int nb_threads = 0,
+                       std::size_t chunk_size = default_parallel_chunk_size) {
+    static_assert(detail::has_jump<RngType>::value,
+                  "random number generator does not provide jump()");
+
+    using difference_type =
+        typename std::iterator_traits<RandomIt>::difference_type;
+
+    const auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (chunk_size==0)
+        chunk_size = default_parallel_chunk_size;
+    const std::size_t nb_chunks = (n + chunk_size - 1)/chunk_size;
+
+    // Generator state for each chunk.
+    std::vector<RngType> streams;
+    streams.reserve(nb_chunks);
+    for (std::size_t c=0; c!=nb_chunks; ++c) {
+        streams.push_back(rng);
+        rng.jump();
+    }
+
+    if (nb_threads==0)
+        nb_threads = std::thread::hardware_concurrency();
+    if (nb_threads==0)
+        nb_threads = 1;
+    if (nb_threads>nb_chunks)
+        nb_threads = static_cast<unsigned int>(nb_chunks);
+
+    std::atomic<std::size_t> next_chunk(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        try {
+            while (true) {
+                std::size_t c = next_chunk.fetch_add(1);
+                if (c>=nb_chunks)
+                    break;
+                std::size_t begin = c*chunk_size;
+                std::size_t end = begin + chunk_size<n ? begin + chunk_size : n;
+                Dist d = dist;
+                d.generate(first + static_cast<difference_type>(begin),
+                           first + static_cast<difference_type>(end),
+                           streams[c]);
+            }
+        }
+        catch (...) {
+            next_chunk = nb_chunks;
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    // The calling thread acts as one of the workers.
+    std::vector<std::thread> threads;
+    try {
+        for (unsigned int t=1; t<nb_threads; ++t)
+            threads.emplace_back(worker);
+    }
+    catch (const std::system_error&) {
+        // Carry on with the threads that could be started.
+    }
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace etf
+
+#endif // ETF_PARALLEL_HPP
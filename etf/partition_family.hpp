@@ -0,0 +1,220 @@
+#ifndef ETF_PARTITION_FAMILY_HPP
+#define ETF_PARTITION_FAMILY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Inner extrema of a monotonic function.
+template<typename RealType>
+struct no_inner_extrema
+{
+    std::array<RealType, 0> operator()(RealType) const {
+        return std::array<RealType, 0>();
+    }
+};
+
+} // namespace detail
+
+
+/// Partitions of a family of functions depending on a parameter.
+///
+/// Partitions are precomputed with `newton_partition` on a grid of parameter
+/// values. A partition for an arbitrary parameter value is then obtained by
+/// interpolating the partitions computed for the neighboring grid values
+/// (after normalization of their abscissae to [0, 1]), optionally refined by
+/// a few warm-started Newton iterations.
+///
+/// The infima and suprema are always computed exactly for the final
+/// abscissae, and the suprema are then lifted so that all upper rectangles
+/// have exactly the same area. The partition is thus valid for the ETF
+/// algorithm even if it is not fully converged, the only consequence of an
+/// imperfect interpolation being a slightly lower fast path probability.
+///
+/// The family is defined by the following function objects, all called with
+/// a parameter value:
+///
+/// * `make_f` and `make_df` return the function and its derivative,
+/// * `bounds` returns the bounds of the partitioned interval as a
+///   `std::pair<RealType, RealType>`,
+/// * `extrema` returns an ordered sequence of the abscissae of the inner
+///   function extrema as a container with `begin()` and `end()` members.
+///
+template<typename RealType, class FuncMaker, class DFuncMaker,
+         class BoundsFunc, class ExtremaFunc>
+class partition_family
+{
+public:
+    /// Computes the partitions for a grid of parameter values.
+    ///
+    /// The parameter values must be sorted in strictly increasing order.
+    /// A `partition_convergence_error` is thrown if the partition cannot be
+    /// computed for one of the grid values.
+    ///
+    template<class InputIt>
+    partition_family(FuncMaker make_f, DFuncMaker make_df,
+                     BoundsFunc bounds, ExtremaFunc extrema,
+                     InputIt theta_first, InputIt theta_last,
+                     std::size_t nb_intervals,
+                     RealType tol)
+    : make_f_(make_f), make_df_(make_df), bounds_(bounds), extrema_(extrema),
+      theta_(theta_first, theta_last), n_(nb_intervals), tol_(tol),
+      workspace_(nb_intervals), x_(nb_intervals + 1) {
+        if (theta_.empty() || nb_intervals==0)
+            throw std::invalid_argument("empty partition family");
+        for (std::size_t j=1; j<theta_.size(); ++j) {
+            if (!(theta_[j - 1]<theta_[j]))
+                throw std::invalid_argument(
+                    "partition family parameters are not sorted");
+        }
+
+        t_.resize(theta_.size()*(n_ + 1));
+        for (std::size_t j=0; j!=theta_.size(); ++j) {
+            const RealType theta = theta_[j];
+            auto f = make_f_(theta);
+            auto df = make_df_(theta);
+            auto e = extrema_(theta);
+            std::pair<RealType, RealType> b = bounds_(theta);
+            auto x_guess = trapezoidal_rule_prepartition(f, b.first, b.second,
+                                                         n_);
+            const auto& p = newton_partition(workspace_, f, df,
+                x_guess.begin(), x_guess.end(), e.begin(), e.end(), tol_);
+            if (p.x.empty())
+                throw partition_convergence_error();
+
+            const RealType scale = RealType(1)/(b.second - b.first);
+            for (std::size_t i=0; i!=(n_ + 1); ++i)
+                t_[j*(n_ + 1) + i] = (p.x[i] - b.first)*scale;
+        }
+    }
+
+    /// Returns the number of grid values.
+    ///
+    std::size_t size() const {
+        return theta_.size();
+    }
+
+    /// Returns the grid of parameter values.
+    ///
+    const std::vector<RealType>& parameters() const {
+        return theta_;
+    }
+
+    /// Returns a partition for the specified parameter value.
+    ///
+    /// The interpolated partition is refined with at most `nb_steps` Newton
+    /// iterations, which are stopped early if the tolerance specified at
+    /// construction is met. Outside the grid, the partition of the nearest
+    /// grid value is used as initial guess.
+    ///
+    /// The returned reference remains valid until the next call.
+    ///
+    const partition_data<RealType>& partition(RealType theta,
+                                              unsigned int nb_steps = 1) {
+        // Interpolate the normalized abscissae.
+        const std::size_t m = theta_.size();
+        std::size_t j = 0;
+        RealType w = 0;
+        if (m>1) {
+            auto it = std::upper_bound(theta_.begin(), theta_.end(), theta);
+            j = it==theta_.begin() ? 0
+                : static_cast<std::size_t>(it - theta_.begin()) - 1;
+            j = std::min(j, m - 2);
+            w = (theta - theta_[j])/(theta_[j + 1] - theta_[j]);
+            w = std::min(std::max(w, RealType(0)), RealType(1));
+        }
+        const RealType* t0 = &t_[j*(n_ + 1)];
+        const RealType* t1 = m>1 ? t0 + (n_ + 1) : t0;
+
+        std::pair<RealType, RealType> b = bounds_(theta);
+        const RealType scale = b.second - b.first;
+        x_.front() = b.first;
+        for (std::size_t i=1; i!=n_; ++i)
+            x_[i] = b.first + scale*((RealType(1) - w)*t0[i] + w*t1[i]);
+        x_.back() = b.second;
+
+        // Refine the partition and compute the exact infima and suprema.
+        auto f = make_f_(theta);
+        auto df = make_df_(theta);
+        auto e = extrema_(theta);
+        serial_evaluation evaluation;
+        auto& p = detail::newton_solver::partition(workspace_);
+        detail::newton_solver::solve(f, df, x_.begin(), x_.end(),
+            e.begin(), e.end(), tol_, RealType(1), nb_steps, evaluation,
+            workspace_, p, true);
+
+        // Lift the suprema so that all upper rectangles have the same area.
+        detail::equalize_upper_areas(p);
+
+        return p;
+    }
+
+private:
+    FuncMaker make_f_;
+    DFuncMaker make_df_;
+    BoundsFunc bounds_;
+    ExtremaFunc extrema_;
+    std::vector<RealType> theta_;
+    std::size_t n_;
+    RealType tol_;
+    std::vector<RealType> t_;
+    partition_workspace<RealType> workspace_;
+    std::vector<RealType> x_;
+};
+
+
+/// Creates a partition family, deducing argument types.
+///
+template<class FuncMaker, class DFuncMaker, class BoundsFunc,
+         class ExtremaFunc, class InputIt, typename RealType>
+inline
+auto make_partition_family(FuncMaker make_f, DFuncMaker make_df,
+                           BoundsFunc bounds, ExtremaFunc extrema,
+                           InputIt theta_first, InputIt theta_last,
+                           std::size_t nb_intervals,
+                           RealType tol)
+-> partition_family<RealType, FuncMaker, DFuncMaker, BoundsFunc,
+                    ExtremaFunc> {
+    return partition_family<RealType, FuncMaker, DFuncMaker, BoundsFunc,
+                            ExtremaFunc>(
+        make_f, make_df, bounds, extrema, theta_first, theta_last,
+        nb_intervals, tol);
+}
+
+
+/// Creates a partition family of monotonic functions, deducing argument
+/// types.
+///
+template<class FuncMaker, class DFuncMaker, class BoundsFunc,
+         class InputIt, typename RealType>
+inline
+auto make_partition_family_monotonic(FuncMaker make_f, DFuncMaker make_df,
+                                     BoundsFunc bounds,
+                                     InputIt theta_first, InputIt theta_last,
+                                     std::size_t nb_intervals,
+                                     RealType tol)
+-> partition_family<RealType, FuncMaker, DFuncMaker, BoundsFunc,
+                    detail::no_inner_extrema<RealType>> {
+    return partition_family<RealType, FuncMaker, DFuncMaker, BoundsFunc,
+                            detail::no_inner_extrema<RealType>>(
+        make_f, make_df, bounds, detail::no_inner_extrema<RealType>(),
+        theta_first, theta_last, nb_intervals, tol);
+}
+
+} // namespace etf
+
+#endif // ETF_PARTITION_FAMILY_HPP
@@ -1,8 +1,11 @@
 #ifndef ETF_RANDOM_DIGITS_HPP
 #define ETF_RANDOM_DIGITS_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 
 
@@ -88,6 +91,71 @@ struct random_bits<UIntType, 0>
 };
 
 
+// Check whether a random number generator produces 64 random bits per call
+// and provides a block output `fill(std::uint64_t*, std::size_t)`.
+template<typename RngType, typename=void>
+struct has_block_output : std::false_type {};
+
+template<typename RngType>
+struct has_block_output<RngType, decltype(void(
+    std::declval<RngType&>().fill(std::declval<std::uint64_t*>(),
+                                  std::size_t())))>
+    : std::integral_constant<bool,
+           RngType::min()==0
+        && RngType::max()==std::numeric_limits<std::uint64_t>::max()> {};
+
+
+// Generate blocks of P random bits.
+//
+// This is the generic implementation, which makes as many calls to the random
+// number generator as necessary.
+template<typename UIntType, std::size_t P, typename RngType, typename=void>
+struct random_bits_block
+{
+    static void generate(RngType& rng, UIntType* r, std::size_t n) {
+        for (std::size_t k=0; k!=n; ++k)
+            r[k] = random_bits<UIntType, P>::generate(rng);
+    }
+};
+
+// Specialization for generators with a 64-bit block output: the block is
+// written in one call and truncated to the P upper bits.
+template<typename UIntType, std::size_t P, typename RngType>
+struct random_bits_block<UIntType, P, RngType,
+    typename std::enable_if<has_block_output<RngType>::value && P<=64>::type>
+{
+    static void generate(RngType& rng, UIntType* r, std::size_t n) {
+        constexpr std::size_t S = 64 - P;
+        constexpr std::size_t B = 256;
+        std::uint64_t buffer[B];
+        while (n!=0) {
+            const std::size_t m = n<B ? n : B;
+            rng.fill(buffer, m);
+            for (std::size_t k=0; k!=m; ++k)
+                r[k] = static_cast<UIntType>(buffer[k] >> S);
+            r += m;
+            n -= m;
+        }
+    }
+};
+
+// Specialization for generators with a 64-bit block output when the block
+// can be written in place.
+template<std::size_t P, typename RngType>
+struct random_bits_block<std::uint64_t, P, RngType,
+    typename std::enable_if<has_block_output<RngType>::value && P<=64>::type>
+{
+    static void generate(RngType& rng, std::uint64_t* r, std::size_t n) {
+        rng.fill(r, n);
+        if (P!=64) {
+            constexpr std::size_t S = P!=64 ? 64 - P : 0;
+            for (std::size_t k=0; k!=n; ++k)
+                r[k] >>= S;
+        }
+    }
+};
+
+
 struct BITFIELD_TOO_WIDE_ERROR;
 
 template<std::size_t N>
@@ -187,6 +255,23 @@ UIntType generate_random_integer(RngType& rng) {
 }
 
 
+/// Generate an array of W-bit precision random integers equidistributed in
+/// [0, 2^W-1].
+///
+/// The result is the same as for `n` successive calls to
+/// `generate_random_integer`, but random number generators which produce 64
+/// random bits per call and provide a block output
+/// `fill(std::uint64_t*, std::size_t)` are used through the block output
+/// whenever W<=64.
+///
+template<typename UIntType, std::size_t W, typename RngType>
+inline
+void generate_random_integers(RngType& rng, UIntType* r, std::size_t n) {
+    detail::check_rng_range<RngType>();
+    detail::random_bits_block<UIntType, W, RngType>::generate(rng, r, n);
+}
+
+
 /// Generate a W-bit precision floating point value in [0,1).
 ///
 /// This a drop-in relacement for std::generate_canonical with the following
@@ -212,12 +297,144 @@ RealType generate_random_real(RngType& rng) {
     constexpr std::size_t N = std::numeric_limits<RealType>::digits;
     constexpr std::size_t M = N<W ? N : W;
     using UIntType = typename integer_traits<M>::uint_fast_t;
+    // If the most significant bit is never set, the conversion can go through
+    // the signed type, which is faster on most platforms.
+    using IntType = typename std::conditional<
+        (M<std::numeric_limits<UIntType>::digits),
+        typename std::make_signed<UIntType>::type, UIntType>::type;
     constexpr RealType S = RealType(1)/(RealType(UIntType(1) << M/2)
                                        *RealType(UIntType(1) << (M - M/2)));
-    return S*static_cast<RealType>(generate_random_integer<UIntType, M>(rng));
+    return S*static_cast<RealType>(
+        static_cast<IntType>(generate_random_integer<UIntType, M>(rng)));
+}
+
+
+/// Random bit pool adapter.
+///
+/// This adapter wraps a random number generator and keeps the random bits
+/// that were drawn from the generator but not consumed: numbers of `W` bits
+/// generated with `generate_random_integer` and `generate_random_real` only
+/// consume `W` bits (or as many bits as the significand of the floating point
+/// type) from the pool, and the generator is only called when the pool runs
+/// out of bits.
+///
+/// This reduces the number of calls to the generator whenever less bits are
+/// requested than the generator produces per call, for instance when
+/// sampling with W<64 from a 64-bit generator, or when generating the extra
+/// floating point numbers needed by the wedge and outer rejection tests.
+/// Note that the sequence of numbers generated through the adapter differs
+/// from that obtained with the bare generator.
+///
+/// The adapter meets the requirements of a uniform random bit generator with
+/// a 64-bit range. The adapted generator must have a range [0, 2^D-1]; it is
+/// owned by the adapter unless `RngType` is a reference type.
+///
+template<typename RngType>
+class bit_pool
+{
+private:
+    using Engine = typename std::remove_reference<RngType>::type;
+    static constexpr std::size_t D = detail::rng_digits<Engine>();
+
+    static_assert(Engine::min()==0 && detail::is_power_of_2_less_1(
+                                          Engine::max()),
+                  "random number generator range is not [0, 2^N-1]");
+    static_assert(D<=64, "random number generator range is too large");
+
+public:
+    using result_type = std::uint64_t;
+
+    bit_pool() = default;
+
+    explicit bit_pool(const Engine& engine) : engine_(engine) {}
+
+    explicit bit_pool(Engine&& engine) : engine_(std::move(engine)) {}
+
+    explicit bit_pool(Engine& engine) : engine_(engine) {}
+
+    /// Returns the smallest value potentially returned by `operator()`.
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    /// Returns the greatest value potentially returned by `operator()`.
+    static constexpr result_type max() {
+        return ~result_type(0);
+    }
+
+    /// Returns 64 random bits.
+    result_type operator()() {
+        return take<result_type, 64>();
+    }
+
+    /// Returns P random bits.
+    template<typename UIntType, std::size_t P>
+    UIntType take() {
+        static_assert(P<=64, "at most 64 bits can be drawn at a time");
+        std::uint64_t r = 0;
+        std::size_t need = P;
+        while (need>nb_bits_) {
+            // Drain the pool and refill it.
+            r = shift_left(r, nb_bits_) | bits_;
+            need -= nb_bits_;
+            bits_ = static_cast<std::uint64_t>(engine_());
+            nb_bits_ = D;
+        }
+        r = shift_left(r, need) | (bits_ & ~shift_left(~std::uint64_t(0), need));
+        bits_ = shift_right(bits_, need);
+        nb_bits_ -= need;
+        return static_cast<UIntType>(r);
+    }
+
+    /// Discards the pooled bits.
+    void reset() {
+        bits_ = 0;
+        nb_bits_ = 0;
+    }
+
+    /// Returns the adapted random number generator.
+    const Engine& base() const {
+        return engine_;
+    }
+
+private:
+    static std::uint64_t shift_left(std::uint64_t x, std::size_t n) {
+        return n<64 ? x << n : 0;
+    }
+
+    static std::uint64_t shift_right(std::uint64_t x, std::size_t n) {
+        return n<64 ? x >> n : 0;
+    }
+
+    RngType engine_;
+    std::uint64_t bits_ = 0;
+    std::size_t nb_bits_ = 0;
+};
+
+
+/// Generate a W-bit precision random integer from a bit pool.
+///
+/// Only W bits are consumed from the pool.
+///
+template<typename UIntType, std::size_t W, typename RngType>
+inline
+UIntType generate_random_integer(bit_pool<RngType>& pool) {
+    return pool.template take<UIntType, W>();
 }
 
 
+/// Generate an array of W-bit precision random integers from a bit pool.
+///
+/// Only W bits per integer are consumed from the pool.
+///
+template<typename UIntType, std::size_t W, typename RngType>
+inline
+void generate_random_integers(bit_pool<RngType>& pool, UIntType* r,
+                              std::size_t n) {
+    for (std::size_t k=0; k!=n; ++k)
+        r[k] = pool.template take<UIntType, W>();
+}
+
 } // namespace etf
 
 #endif // ETF_RANDOM_DIGITS_HPP
@@ -0,0 +1,482 @@
+#ifndef ETF_SIMD_HPP
+#define ETF_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Vectorized kernels can be disabled altogether by defining ETF_NO_SIMD.
+#if !defined(ETF_NO_SIMD)
+#   if defined(__AVX512F__) && defined(__AVX512DQ__)
+#       define ETF_SIMD_AVX512
+#   elif defined(__AVX2__)
+#       define ETF_SIMD_AVX2
+#   endif
+#endif
+
+#if defined(ETF_SIMD_AVX512) || defined(ETF_SIMD_AVX2)
+#include <immintrin.h>
+#endif
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Vectorized fast path kernel for central distributions.
+//
+// The kernel processes a block of random integers by groups of SIMD lanes:
+// for each lane, the table index, mantissa and sign are extracted from the
+// random integer, the table data are gathered, the candidate value is
+// computed and the lane is appended to the list of misses if the fast path
+// test fails.
+// The number of random integers processed is returned; the remainder of the
+// block (if any) is left to the scalar fast path.
+//
+// The table data is accessed via raw pointers to the first abscissa, to the
+// first `scaled_fratio` and to the first `scaled_dx`; abscissae are spaced by
+// `x_stride` bytes and the other data by `stride` bytes.
+//
+// This generic kernel is used whenever no vectorized implementation is
+// available for the specified types: it processes no random integer at all.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N,
+         typename=void>
+struct central_kernel
+{
+    static std::size_t run(const UIntType*, RealType*, std::size_t,
+                           unsigned short*, std::size_t&,
+                           const RealType*, std::size_t,
+                           const UIntType*, const RealType*, std::size_t) {
+        return 0;
+    }
+};
+
+
+#if defined(ETF_SIMD_AVX512) || defined(ETF_SIMD_AVX2)
+
+// Condition for the availability of a vectorized double precision kernel.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+using enable_simd_double_t = typename std::enable_if<
+       std::is_same<RealType, double>::value
+    && sizeof(UIntType)==8 && W<=64 && (W>N+1)>::type;
+
+// Condition for the availability of a vectorized single precision kernel.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+using enable_simd_float_t = typename std::enable_if<
+       std::is_same<RealType, float>::value
+    && sizeof(UIntType)==4 && W<=32 && (W>N+1)>::type;
+
+#endif
+
+
+#if defined(ETF_SIMD_AVX512)
+
+// AVX-512 kernel for double precision and random integers of up to 64 bits.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+struct central_kernel<RealType, UIntType, W, N,
+                      enable_simd_double_t<RealType, UIntType, W, N>>
+{
+    static std::size_t run(const UIntType* r, double* x, std::size_t m,
+                           unsigned short* miss, std::size_t& nb_miss,
+                           const double* x_table, std::size_t x_stride,
+                           const UIntType* fratio, const double* dx,
+                           std::size_t stride) {
+        const __m512i m_mask = _mm512_set1_epi64(
+            static_cast<long long>((UIntType(1) << (W - N - 1)) - 1));
+        const __m512i i_mask = _mm512_set1_epi64((1LL << N) - 1);
+        const __m512i sign_mask = _mm512_set1_epi64(
+            static_cast<long long>(std::uint64_t(1) << 63));
+        const __m512i vstride = _mm512_set1_epi64(
+            static_cast<long long>(stride));
+        const __m512i vx_stride = _mm512_set1_epi64(
+            static_cast<long long>(x_stride));
+
+        std::size_t k = 0;
+        for (; k + 8<=m; k += 8) {
+            __m512i vr = _mm512_loadu_si512(r + k);
+            // Mantissa, table index and byte offsets into the table.
+            __m512i u = _mm512_and_si512(vr, m_mask);
+            __m512i i = _mm512_and_si512(_mm512_srli_epi64(vr, W - N - 1),
+                                         i_mask);
+            __m512i offset = _mm512_mul_epu32(i, vstride);
+            __m512i x_offset = _mm512_mul_epu32(i, vx_stride);
+            // Gather table data.
+            __m512i vfratio = _mm512_i64gather_epi64(offset, fratio, 1);
+            __m512d vdx = _mm512_i64gather_pd(offset, dx, 1);
+            __m512d vx = _mm512_i64gather_pd(x_offset, x_table, 1);
+            // Candidate value, with its sign flipped if bit (W-1) is not set.
+            __m512d y = _mm512_add_pd(
+                vx, _mm512_mul_pd(vdx, _mm512_cvtepu64_pd(u)));
+            __m512i s = _mm512_andnot_si512(_mm512_slli_epi64(vr, 64 - W),
+                                            sign_mask);
+            y = _mm512_castsi512_pd(
+                _mm512_xor_si512(_mm512_castpd_si512(y), s));
+            _mm512_storeu_pd(x + k, y);
+            // Append the misses.
+            unsigned hits = _mm512_cmplt_epu64_mask(u, vfratio);
+            for (unsigned l=0; l!=8; ++l) {
+                miss[nb_miss] = static_cast<unsigned short>(k + l);
+                nb_miss += ((hits >> l) & 1) ^ 1;
+            }
+        }
+
+        return k;
+    }
+};
+
+// AVX-512 kernel for single precision and random integers of up to 32 bits.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+struct central_kernel<RealType, UIntType, W, N,
+                      enable_simd_float_t<RealType, UIntType, W, N>>
+{
+    static std::size_t run(const UIntType* r, float* x, std::size_t m,
+                           unsigned short* miss, std::size_t& nb_miss,
+                           const float* x_table, std::size_t x_stride,
+                           const UIntType* fratio, const float* dx,
+                           std::size_t stride) {
+        const __m512i m_mask = _mm512_set1_epi32(
+            static_cast<int>((UIntType(1) << (W - N - 1)) - 1));
+        const __m512i i_mask = _mm512_set1_epi32((1 << N) - 1);
+        const __m512i sign_mask = _mm512_set1_epi32(
+            static_cast<int>(std::uint32_t(1) << 31));
+        const __m512i vstride = _mm512_set1_epi32(static_cast<int>(stride));
+        const __m512i vx_stride = _mm512_set1_epi32(
+            static_cast<int>(x_stride));
+
+        std::size_t k = 0;
+        for (; k + 16<=m; k += 16) {
+            __m512i vr = _mm512_loadu_si512(r + k);
+            // Mantissa, table index and byte offsets into the table.
+            __m512i u = _mm512_and_si512(vr, m_mask);
+            __m512i i = _mm512_and_si512(_mm512_srli_epi32(vr, W - N - 1),
+                                         i_mask);
+            __m512i offset = _mm512_mullo_epi32(i, vstride);
+            __m512i x_offset = _mm512_mullo_epi32(i, vx_stride);
+            // Gather table data.
+            __m512i vfratio = _mm512_i32gather_epi32(offset, fratio, 1);
+            __m512 vdx = _mm512_i32gather_ps(offset, dx, 1);
+            __m512 vx = _mm512_i32gather_ps(x_offset, x_table, 1);
+            // Candidate value, with its sign flipped if bit (W-1) is not set;
+            // the mantissa is less than 2^31 so it can be converted as a
+            // signed integer.
+            __m512 y = _mm512_add_ps(
+                vx, _mm512_mul_ps(vdx, _mm512_cvtepi32_ps(u)));
+            __m512i s = _mm512_andnot_si512(_mm512_slli_epi32(vr, 32 - W),
+                                            sign_mask);
+            y = _mm512_castsi512_ps(
+                _mm512_xor_si512(_mm512_castps_si512(y), s));
+            _mm512_storeu_ps(x + k, y);
+            // Append the misses.
+            unsigned hits = _mm512_cmplt_epu32_mask(u, vfratio);
+            for (unsigned l=0; l!=16; ++l) {
+                miss[nb_miss] = static_cast<unsigned short>(k + l);
+                nb_miss += ((hits >> l) & 1) ^ 1;
+            }
+        }
+
+        return k;
+    }
+};
+
+#elif defined(ETF_SIMD_AVX2)
+
+// AVX2 kernel for double precision and random integers of up to 64 bits.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+struct central_kernel<RealType, UIntType, W, N,
+                      enable_simd_double_t<RealType, UIntType, W, N>>
+{
+    static std::size_t run(const UIntType* r, double* x, std::size_t m,
+                           unsigned short* miss, std::size_t& nb_miss,
+                           const double* x_table, std::size_t x_stride,
+                           const UIntType* fratio, const double* dx,
+                           std::size_t stride) {
+        const __m256i m_mask = _mm256_set1_epi64x(
+            static_cast<long long>((UIntType(1) << (W - N - 1)) - 1));
+        const __m256i i_mask = _mm256_set1_epi64x((1LL << N) - 1);
+        const __m256i sign_mask = _mm256_set1_epi64x(
+            static_cast<long long>(std::uint64_t(1) << 63));
+        const __m256i vstride = _mm256_set1_epi64x(
+            static_cast<long long>(stride));
+        const __m256i vx_stride = _mm256_set1_epi64x(
+            static_cast<long long>(x_stride));
+        const auto* fratio_base = reinterpret_cast<const long long*>(fratio);
+
+        std::size_t k = 0;
+        for (; k + 4<=m; k += 4) {
+            __m256i vr = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(r + k));
+            // Mantissa, table index and byte offsets into the table.
+            __m256i u = _mm256_and_si256(vr, m_mask);
+            __m256i i = _mm256_and_si256(_mm256_srli_epi64(vr, W - N - 1),
+                                         i_mask);
+            __m256i offset = _mm256_mul_epu32(i, vstride);
+            __m256i x_offset = _mm256_mul_epu32(i, vx_stride);
+            // Gather table data.
+            __m256i vfratio = _mm256_i64gather_epi64(fratio_base, offset, 1);
+            __m256d vdx = _mm256_i64gather_pd(dx, offset, 1);
+            __m256d vx = _mm256_i64gather_pd(x_table, x_offset, 1);
+            // Candidate value, with its sign flipped if bit (W-1) is not set.
+            __m256d y = _mm256_add_pd(vx,
+                                      _mm256_mul_pd(vdx, to_double(u)));
+            __m256i s = _mm256_andnot_si256(_mm256_slli_epi64(vr, 64 - W),
+                                            sign_mask);
+            y = _mm256_castsi256_pd(
+                _mm256_xor_si256(_mm256_castpd_si256(y), s));
+            _mm256_storeu_pd(x + k, y);
+            // Append the misses; since the mantissa and the fratio are both
+            // less than 2^63, a signed comparison can be used.
+            unsigned hits = static_cast<unsigned>(_mm256_movemask_pd(
+                _mm256_castsi256_pd(_mm256_cmpgt_epi64(vfratio, u))));
+            for (unsigned l=0; l!=4; ++l) {
+                miss[nb_miss] = static_cast<unsigned short>(k + l);
+                nb_miss += ((hits >> l) & 1) ^ 1;
+            }
+        }
+
+        return k;
+    }
+
+private:
+    // Converts unsigned 64-bit integers to doubles.
+    //
+    // The high and low 32-bit halves are converted exactly using the magic
+    // number method so that the result is only rounded once, by the final
+    // addition, just like a scalar conversion.
+    static __m256d to_double(__m256i u) {
+        const __m256i magic_lo = _mm256_set1_epi64x(0x4330000000000000LL);
+        const __m256i magic_hi = _mm256_set1_epi64x(0x4530000000000000LL);
+        const __m256d magic_hi_lo = _mm256_set1_pd(19342813118337666422669312.);
+        __m256i lo = _mm256_blend_epi32(magic_lo, u, 0x55);
+        __m256i hi = _mm256_xor_si256(_mm256_srli_epi64(u, 32), magic_hi);
+        __m256d h = _mm256_sub_pd(_mm256_castsi256_pd(hi), magic_hi_lo);
+        return _mm256_add_pd(h, _mm256_castsi256_pd(lo));
+    }
+};
+
+// AVX2 kernel for single precision and random integers of up to 32 bits.
+template<typename RealType, typename UIntType, std::size_t W, std::size_t N>
+struct central_kernel<RealType, UIntType, W, N,
+                      enable_simd_float_t<RealType, UIntType, W, N>>
+{
+    static std::size_t run(const UIntType* r, float* x, std::size_t m,
+                           unsigned short* miss, std::size_t& nb_miss,
+                           const float* x_table, std::size_t x_stride,
+                           const UIntType* fratio, const float* dx,
+                           std::size_t stride) {
+        const __m256i m_mask = _mm256_set1_epi32(
+            static_cast<int>((UIntType(1) << (W - N - 1)) - 1));
+        const __m256i i_mask = _mm256_set1_epi32((1 << N) - 1);
+        const __m256i sign_mask = _mm256_set1_epi32(
+            static_cast<int>(std::uint32_t(1) << 31));
+        const __m256i vstride = _mm256_set1_epi32(static_cast<int>(stride));
+        const __m256i vx_stride = _mm256_set1_epi32(
+            static_cast<int>(x_stride));
+        const auto* fratio_base = reinterpret_cast<const int*>(fratio);
+
+        std::size_t k = 0;
+        for (; k + 8<=m; k += 8) {
+            __m256i vr = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(r + k));
+            // Mantissa, table index and byte offsets into the table.
+            __m256i u = _mm256_and_si256(vr, m_mask);
+            __m256i i = _mm256_and_si256(_mm256_srli_epi32(vr, W - N - 1),
+                                         i_mask);
+            __m256i offset = _mm256_mullo_epi32(i, vstride);
+            __m256i x_offset = _mm256_mullo_epi32(i, vx_stride);
+            // Gather table data.
+            __m256i vfratio = _mm256_i32gather_epi32(fratio_base, offset, 1);
+            __m256 vdx = _mm256_i32gather_ps(dx, offset, 1);
+            __m256 vx = _mm256_i32gather_ps(x_table, x_offset, 1);
+            // Candidate value, with its sign flipped if bit (W-1) is not set;
+            // the mantissa is less than 2^31 so it can be converted as a
+            // signed integer.
+            __m256 y = _mm256_add_ps(
+                vx, _mm256_mul_ps(vdx, _mm256_cvtepi32_ps(u)));
+            __m256i s = _mm256_andnot_si256(_mm256_slli_epi32(vr, 32 - W),
+                                            sign_mask);
+            y = _mm256_castsi256_ps(
+                _mm256_xor_si256(_mm256_castps_si256(y), s));
+            _mm256_storeu_ps(x + k, y);
+            // Append the misses; since the mantissa and the fratio are both
+            // less than 2^31, a signed comparison can be used.
+            unsigned hits = static_cast<unsigned>(_mm256_movemask_ps(
+                _mm256_castsi256_ps(_mm256_cmpgt_epi32(vfratio, u))));
+            for (unsigned l=0; l!=8; ++l) {
+                miss[nb_miss] = static_cast<unsigned short>(k + l);
+                nb_miss += ((hits >> l) & 1) ^ 1;
+            }
+        }
+
+        return k;
+    }
+};
+
+#endif
+
+
+// Row kernel of the triangular matrix product of multivariate normal
+// distributions.
+//
+// The kernel computes the products of two rows `l0` and `l1` of a matrix by a
+// block of `B` column vectors, the `k`-th components of which are contiguous
+// at `z + k*B`:
+//
+//     y0[v] = sum over k<len of l0[k]*z[k*B + v]
+//
+// and likewise for `y1` and `l1`. Both rows are processed together so that
+// each component of the block is loaded once for two products.
+//
+// This generic kernel is used whenever no vectorized implementation is
+// available for the specified types.
+template<typename RealType, std::size_t B>
+struct row_pair_kernel
+{
+    static void run(const RealType* l0, const RealType* l1, std::size_t len,
+                    const RealType* z, RealType* y0, RealType* y1) {
+        RealType acc0[B] = {};
+        RealType acc1[B] = {};
+        for (std::size_t k=0; k!=len; ++k, z+=B) {
+            const RealType a = l0[k];
+            const RealType b = l1[k];
+            for (std::size_t v=0; v!=B; ++v) {
+                acc0[v] += a*z[v];
+                acc1[v] += b*z[v];
+            }
+        }
+        for (std::size_t v=0; v!=B; ++v) {
+            y0[v] = acc0[v];
+            y1[v] = acc1[v];
+        }
+    }
+};
+
+
+#if defined(ETF_SIMD_AVX512)
+
+// AVX-512 kernel for double precision and blocks of 16 vectors.
+template<>
+struct row_pair_kernel<double, 16>
+{
+    static void run(const double* l0, const double* l1, std::size_t len,
+                    const double* z, double* y0, double* y1) {
+        __m512d a0 = _mm512_setzero_pd();
+        __m512d a1 = _mm512_setzero_pd();
+        __m512d b0 = _mm512_setzero_pd();
+        __m512d b1 = _mm512_setzero_pd();
+        for (std::size_t k=0; k!=len; ++k, z+=16) {
+            __m512d z0 = _mm512_loadu_pd(z);
+            __m512d z1 = _mm512_loadu_pd(z + 8);
+            __m512d la = _mm512_set1_pd(l0[k]);
+            __m512d lb = _mm512_set1_pd(l1[k]);
+            a0 = _mm512_fmadd_pd(la, z0, a0);
+            a1 = _mm512_fmadd_pd(la, z1, a1);
+            b0 = _mm512_fmadd_pd(lb, z0, b0);
+            b1 = _mm512_fmadd_pd(lb, z1, b1);
+        }
+        _mm512_storeu_pd(y0, a0);
+        _mm512_storeu_pd(y0 + 8, a1);
+        _mm512_storeu_pd(y1, b0);
+        _mm512_storeu_pd(y1 + 8, b1);
+    }
+};
+
+// AVX-512 kernel for single precision and blocks of 16 vectors.
+template<>
+struct row_pair_kernel<float, 16>
+{
+    static void run(const float* l0, const float* l1, std::size_t len,
+                    const float* z, float* y0, float* y1) {
+        __m512 a = _mm512_setzero_ps();
+        __m512 b = _mm512_setzero_ps();
+        for (std::size_t k=0; k!=len; ++k, z+=16) {
+            __m512 vz = _mm512_loadu_ps(z);
+            a = _mm512_fmadd_ps(_mm512_set1_ps(l0[k]), vz, a);
+            b = _mm512_fmadd_ps(_mm512_set1_ps(l1[k]), vz, b);
+        }
+        _mm512_storeu_ps(y0, a);
+        _mm512_storeu_ps(y1, b);
+    }
+};
+
+#elif defined(ETF_SIMD_AVX2)
+
+// AVX2 kernel for double precision and blocks of 16 vectors.
+//
+// FMA instructions are not part of AVX2 proper, so products and sums are
+// computed separately.
+template<>
+struct row_pair_kernel<double, 16>
+{
+    static void run(const double* l0, const double* l1, std::size_t len,
+                    const double* z, double* y0, double* y1) {
+        __m256d a0 = _mm256_setzero_pd();
+        __m256d a1 = _mm256_setzero_pd();
+        __m256d a2 = _mm256_setzero_pd();
+        __m256d a3 = _mm256_setzero_pd();
+        __m256d b0 = _mm256_setzero_pd();
+        __m256d b1 = _mm256_setzero_pd();
+        __m256d b2 = _mm256_setzero_pd();
+        __m256d b3 = _mm256_setzero_pd();
+        for (std::size_t k=0; k!=len; ++k, z+=16) {
+            __m256d z0 = _mm256_loadu_pd(z);
+            __m256d z1 = _mm256_loadu_pd(z + 4);
+            __m256d z2 = _mm256_loadu_pd(z + 8);
+            __m256d z3 = _mm256_loadu_pd(z + 12);
+            __m256d la = _mm256_set1_pd(l0[k]);
+            __m256d lb = _mm256_set1_pd(l1[k]);
+            a0 = _mm256_add_pd(a0, _mm256_mul_pd(la, z0));
+            a1 = _mm256_add_pd(a1, _mm256_mul_pd(la, z1));
+            a2 = _mm256_add_pd(a2, _mm256_mul_pd(la, z2));
+            a3 = _mm256_add_pd(a3, _mm256_mul_pd(la, z3));
+            b0 = _mm256_add_pd(b0, _mm256_mul_pd(lb, z0));
+            b1 = _mm256_add_pd(b1, _mm256_mul_pd(lb, z1));
+            b2 = _mm256_add_pd(b2, _mm256_mul_pd(lb, z2));
+            b3 = _mm256_add_pd(b3, _mm256_mul_pd(lb, z3));
+        }
+        _mm256_storeu_pd(y0, a0);
+        _mm256_storeu_pd(y0 + 4, a1);
+        _mm256_storeu_pd(y0 + 8, a2);
+        _mm256_storeu_pd(y0 + 12, a3);
+        _mm256_storeu_pd(y1, b0);
+        _mm256_storeu_pd(y1 + 4, b1);
+        _mm256_storeu_pd(y1 + 8, b2);
+        _mm256_storeu_pd(y1 + 12, b3);
+    }
+};
+
+// AVX2 kernel for single precision and blocks of 16 vectors.
+template<>
+struct row_pair_kernel<float, 16>
+{
+    static void run(const float* l0, const float* l1, std::size_t len,
+                    const float* z, float* y0, float* y1) {
+        __m256 a0 = _mm256_setzero_ps();
+        __m256 a1 = _mm256_setzero_ps();
+        __m256 b0 = _mm256_setzero_ps();
+        __m256 b1 = _mm256_setzero_ps();
+        for (std::size_t k=0; k!=len; ++k, z+=16) {
+            __m256 z0 = _mm256_loadu_ps(z);
+            __m256 z1 = _mm256_loadu_ps(z + 8);
+            __m256 la = _mm256_set1_ps(l0[k]);
+            __m256 lb = _mm256_set1_ps(l1[k]);
+            a0 = _mm256_add_ps(a0, _mm256_mul_ps(la, z0));
+            a1 = _mm256_add_ps(a1, _mm256_mul_ps(la, z1));
+            b0 = _mm256_add_ps(b0, _mm256_mul_ps(lb, z0));
+            b1 = _mm256_add_ps(b1, _mm256_mul_ps(lb, z1));
+        }
+        _mm256_storeu_ps(y0, a0);
+        _mm256_storeu_ps(y0 + 8, a1);
+        _mm256_storeu_ps(y1, b0);
+        _mm256_storeu_ps(y1 + 8, b1);
+    }
+};
+
+#endif
+
+} // namespace detail
+
+} // namespace etf
+
+#endif // ETF_SIMD_HPP
@@ -0,0 +1,208 @@
+#ifndef ETF_STANDARD_PARTITIONS_HPP
+#define ETF_STANDARD_PARTITIONS_HPP
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Tabulated normal tail positions for N=7 and N=8.
+template<typename RealType>
+struct normal_magic_xtail
+{
+    static constexpr RealType n7[8] =
+        { 1.532095304, 1.859950459, 2.150455371, 2.413614185,
+          2.655703474, 2.880953316, 3.092363645, 3.292145211 };
+    static constexpr RealType n8[8] =
+        { 1.533103263, 1.861331463, 2.152146391, 2.415553089,
+          2.657829951, 2.883210552, 3.094702254, 3.294526271 };
+};
+
+template<typename RealType>
+constexpr RealType normal_magic_xtail<RealType>::n7[8];
+
+template<typename RealType>
+constexpr RealType normal_magic_xtail<RealType>::n8[8];
+
+} // namespace detail
+
+
+/// Returns the tail position of a central normal distribution.
+///
+/// For high precision (W large), the position of the tail can be chosen
+/// rather freely; for low W values, though, the tail position should be
+/// chosen such that the area of the tail relatively to the whole area sampled
+/// (upper rectangles + tail) is a multiple of 1/2^(W-N-1) so as to avoid
+/// excessive rounding errors on the sampling probability.
+/// Magical values that are closest to the empirical optimum of the tail
+/// position (around 3.25) are tabulated for the common cases N=7 and N=8.
+///
+template<typename RealType>
+constexpr RealType normal_xtail(std::size_t W, std::size_t N) {
+    return (N==7 && W>=11) ?
+               detail::normal_magic_xtail<RealType>::n7[W - 11<7 ? W - 11 : 7]
+         : (N==8 && W>=12) ?
+               detail::normal_magic_xtail<RealType>::n8[W - 12<7 ? W - 12 : 7]
+         : RealType(3.25); // let's hope W is large...
+}
+
+
+/// Returns the tail position of an exponential distribution.
+///
+/// The tail area is about 1/1100 of the total area; no attempt is made to
+/// compensate rounding errors on the sampling probability, which is thus
+/// only suitable for high precision (W large).
+///
+template<typename RealType>
+constexpr RealType exponential_xtail(std::size_t, std::size_t) {
+    return RealType(7.0);
+}
+
+
+#if __cplusplus >= 201703L
+
+/// Largest value of `N` supported by the partitions computed at compile
+/// time.
+///
+/// Larger partitions exceed the default limits of compilers on the cost of
+/// constant expressions.
+///
+constexpr std::size_t static_partition_max_n = 10;
+
+
+namespace detail {
+
+// Area under exp(-x^2/2) over [x, +inf), computed with the continued
+// fraction expansion of Mills' ratio, which converges well for x > 1.
+template<typename RealType>
+constexpr RealType static_normal_tail_area(RealType x) {
+    long double t = x;
+    for (int k=4000; k!=0; --k) {
+        t = x + k/t;
+    }
+    return static_exp(RealType(-0.5)*x*x)/static_cast<RealType>(t);
+}
+
+
+// Partitions of the standard distributions over [0, xtail]. The overloads
+// taking std::false_type are only selected when N is out of range, so as to
+// report the failed static assertion of the caller rather than an exceeded
+// constant evaluation limit.
+template<std::size_t M, typename RealType>
+constexpr static_partition_data<RealType, M>
+static_normal_partition_data(RealType xtail, std::true_type) {
+    return static_newton_partition_monotonic(
+        [](RealType x) { return static_exp(RealType(-0.5)*x*x); },
+        [](RealType x) { return -x*static_exp(RealType(-0.5)*x*x); },
+        static_trapezoidal_rule_prepartition<M>(
+            [](RealType x) { return static_exp(RealType(-0.5)*x*x); },
+            RealType(0), xtail),
+        std::numeric_limits<RealType>::epsilon()*RealType(1e4));
+}
+
+template<std::size_t M, typename RealType>
+constexpr static_partition_data<RealType, M>
+static_exponential_partition_data(RealType xtail, std::true_type) {
+    return static_newton_partition_monotonic(
+        [](RealType x) { return static_exp(-x); },
+        [](RealType x) { return -static_exp(-x); },
+        static_trapezoidal_rule_prepartition<M>(
+            [](RealType x) { return static_exp(-x); },
+            RealType(0), xtail),
+        std::numeric_limits<RealType>::epsilon()*RealType(1e4));
+}
+
+template<std::size_t M, typename RealType>
+constexpr static_partition_data<RealType, M>
+static_normal_partition_data(RealType, std::false_type) {
+    return {};
+}
+
+template<std::size_t M, typename RealType>
+constexpr static_partition_data<RealType, M>
+static_exponential_partition_data(RealType, std::false_type) {
+    return {};
+}
+
+} // namespace detail
+
+
+/// Partition of a central normal distribution computed at compile time.
+///
+/// The partition covers the interval [0, `xtail`] of the non-normalized
+/// probability density function `exp(-x^2/2)`; `tail_area` is the area under
+/// this function over [`xtail`, +inf).
+///
+/// `N` must not exceed `static_partition_max_n`.
+///
+/// Requires C++17.
+///
+template<typename RealType, std::size_t W, std::size_t N>
+struct static_normal_partition
+{
+    static_assert(N<=static_partition_max_n,
+                  "N is too large for a partition computed at compile time");
+
+    static constexpr RealType xtail = normal_xtail<RealType>(W, N);
+
+    static constexpr RealType tail_area =
+        detail::static_normal_tail_area(xtail);
+
+    static constexpr static_partition_data<RealType, std::size_t(1) << N>
+    partition = detail::static_normal_partition_data<std::size_t(1) << N>(
+        xtail, std::integral_constant<bool, N<=static_partition_max_n>());
+};
+
+
+/// Partition of an exponential distribution computed at compile time.
+///
+/// The partition covers the interval [0, `xtail`] of the probability density
+/// function `exp(-x)`; `tail_area` is the area under this function over
+/// [`xtail`, +inf).
+///
+/// `N` must not exceed `static_partition_max_n`.
+///
+/// Requires C++17.
+///
+template<typename RealType, std::size_t W, std::size_t N>
+struct static_exponential_partition
+{
+    static_assert(N<=static_partition_max_n,
+                  "N is too large for a partition computed at compile time");
+
+    static constexpr RealType xtail = exponential_xtail<RealType>(W, N);
+
+    static constexpr RealType tail_area = static_exp(-xtail);
+
+    static constexpr static_partition_data<RealType, std::size_t(1) << N>
+    partition = detail::static_exponential_partition_data<std::size_t(1) << N>(
+        xtail, std::integral_constant<bool, N<=static_partition_max_n>());
+};
+
+#endif // __cplusplus >= 201703L
+
+
+namespace detail {
+
+// Whether the standard partitions of size 2^N are computed at compile time.
+template<std::size_t N>
+struct use_static_partition
+#if __cplusplus >= 201703L
+    : std::integral_constant<bool, N<=static_partition_max_n> {};
+#else
+    : std::false_type {};
+#endif
+
+} // namespace detail
+
+} // namespace etf
+
+#endif // ETF_STANDARD_PARTITIONS_HPP
@@ -0,0 +1,168 @@
+#ifndef ETF_STATISTICS_HPP
+#define ETF_STATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "random_digits.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Statistics policy which does not record anything.
+///
+/// This is the default policy; it has no run-time cost.
+///
+struct no_statistics {};
+
+
+/// Statistics policy which records the sampling paths taken.
+///
+/// The counters are updated on each sample and can be retrieved with the
+/// `statistics()` member of the distribution.
+///
+struct sampling_statistics {};
+
+
+/// Sampling path counters.
+///
+/// Each sample is generated either with the fast path or after one or more
+/// iterations of the slow path; each iteration of the slow path samples either
+/// a wedge or the outer distribution and may be rejected, in which case a new
+/// random number is drawn and the fast path is attempted again. Therefore:
+///
+///     samples = fast + (wedge - wedge_rejections) +
+///                      (outer - outer_rejections)
+///
+/// Engine calls include calls made by the outer distribution, if any, and
+/// count each 64-bit number produced by the block output of generators which
+/// provide one. Calls are not counted for generators adapted by a `bit_pool`,
+/// whose pooled bits are not tracked.
+///
+struct sampling_counters
+{
+    std::uint64_t samples = 0;          ///< generated samples
+    std::uint64_t fast = 0;             ///< samples returned by the fast path
+    std::uint64_t wedge = 0;            ///< wedge samples attempted
+    std::uint64_t wedge_rejections = 0; ///< wedge samples rejected
+    std::uint64_t outer = 0;            ///< outer samples attempted
+    std::uint64_t outer_rejections = 0; ///< outer samples rejected
+    std::uint64_t engine_calls = 0;     ///< calls to the random generator
+};
+
+
+namespace detail {
+
+// Forwards calls to a random number generator and counts them.
+template<typename RngType>
+class counting_rng
+{
+public:
+    using result_type = typename RngType::result_type;
+
+    counting_rng(RngType& rng, std::uint64_t& count)
+    : rng_(rng), count_(count) {}
+
+    static constexpr result_type min() {
+        return RngType::min();
+    }
+
+    static constexpr result_type max() {
+        return RngType::max();
+    }
+
+    result_type operator()() {
+        ++count_;
+        return rng_();
+    }
+
+    // Only defined if the generator provides a block output.
+    template<typename R=RngType>
+    auto fill(std::uint64_t* first, std::size_t n)
+    -> decltype(std::declval<R&>().fill(first, n)) {
+        count_ += n;
+        return rng_.fill(first, n);
+    }
+
+private:
+    RngType& rng_;
+    std::uint64_t& count_;
+};
+
+
+// Records the sampling statistics; this is used as a base class of the
+// distributions.
+template<typename Statistics>
+class statistics_recorder;
+
+template<>
+class statistics_recorder<no_statistics>
+{
+protected:
+    template<class RngType>
+    static RngType& engine(RngType& g) { return g; }
+
+    static void record_samples(std::size_t) {}
+
+    static void record_fast(std::size_t) {}
+
+    static void record_wedge(bool) {}
+
+    static void record_outer(bool) {}
+};
+
+template<>
+class statistics_recorder<sampling_statistics>
+{
+public:
+    /// Returns the sampling path counters.
+    ///
+    const sampling_counters& statistics() const {
+        return counters_;
+    }
+
+    /// Resets the sampling path counters.
+    ///
+    void reset_statistics() {
+        counters_ = sampling_counters();
+    }
+
+protected:
+    template<class RngType>
+    counting_rng<RngType> engine(RngType& g) {
+        return counting_rng<RngType>(g, counters_.engine_calls);
+    }
+
+    template<class RngType>
+    static bit_pool<RngType>& engine(bit_pool<RngType>& g) { return g; }
+
+    void record_samples(std::size_t n) {
+        counters_.samples += n;
+    }
+
+    void record_fast(std::size_t n) {
+        counters_.fast += n;
+    }
+
+    void record_wedge(bool accepted) {
+        ++counters_.wedge;
+        counters_.wedge_rejections += accepted ? 0 : 1;
+    }
+
+    void record_outer(bool accepted) {
+        ++counters_.outer;
+        counters_.outer_rejections += accepted ? 0 : 1;
+    }
+
+private:
+    sampling_counters counters_;
+};
+
+} // namespace detail
+
+} // namespace etf
+
+#endif // ETF_STATISTICS_HPP
@@ -0,0 +1,156 @@
+#ifndef ETF_STUDENT_T_HPP
+#define ETF_STUDENT_T_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+#include "gamma.hpp"
+#include "normal.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Student's t-distribution.
+///
+/// This distribution has the same interface as
+/// `std::student_t_distribution`. Variates are computed as
+/// `z*sqrt(n/(2*y))`, where `z` is a standard normal variate generated with
+/// the standard normal ETF distribution of `normal_distribution` and `y` a
+/// gamma variate with shape parameter `n/2` generated with the ETF tables of
+/// `gamma_distribution` for that shape.
+///
+template<typename RealType=double, std::size_t W=64, std::size_t N=8>
+class student_t_distribution
+{
+private:
+    using gamma_type = gamma_distribution<RealType, W, N>;
+
+public:
+    using result_type = RealType;
+
+    /// Distribution parameters.
+    ///
+    class param_type
+    {
+    public:
+        using distribution_type = student_t_distribution;
+
+        explicit param_type(RealType n=1.0)
+        : n_(n), gamma_params_(RealType(0.5)*n) {}
+
+        RealType n() const { return n_; }
+
+        friend bool operator==(const param_type& a, const param_type& b) {
+            return a.n_==b.n_;
+        }
+
+        friend bool operator!=(const param_type& a, const param_type& b) {
+            return !(a==b);
+        }
+
+    private:
+        friend class student_t_distribution;
+
+        RealType n_;
+        typename gamma_type::param_type gamma_params_;
+    };
+
+    student_t_distribution() : student_t_distribution(1.0) {}
+
+    explicit student_t_distribution(RealType n)
+    : student_t_distribution(param_type(n)) {}
+
+    explicit student_t_distribution(const param_type& params)
+    : params_(params),
+      z_(detail::standard_normal_tables<RealType, W, N>()),
+      gamma_(params.gamma_params_) {}
+
+    void reset() {}
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        return (*this)(g, params_);
+    }
+
+    /// Returns a random number generated with the specified parameters.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g, const param_type& params) const {
+        RealType y = gamma_(g, params.gamma_params_);
+        return z_(g)*std::sqrt(RealType(0.5)*params.n_/y);
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        for (; first!=last; ++first)
+            *first = (*this)(g, params_);
+    }
+
+    RealType n() const { return params_.n(); }
+
+    param_type param() const { return params_; }
+
+    void param(const param_type& params) { params_ = params; }
+
+    result_type min() const {
+        return std::numeric_limits<RealType>::lowest();
+    }
+
+    result_type max() const {
+        return std::numeric_limits<RealType>::max();
+    }
+
+    friend bool operator==(const student_t_distribution& a,
+                           const student_t_distribution& b) {
+        return a.params_==b.params_;
+    }
+
+    friend bool operator!=(const student_t_distribution& a,
+                           const student_t_distribution& b) {
+        return !(a==b);
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits>&
+    operator<<(std::basic_ostream<CharT, Traits>& os,
+               const student_t_distribution& d) {
+        auto flags = os.flags(std::ios_base::scientific);
+        auto precision = os.precision(
+            std::numeric_limits<RealType>::max_digits10);
+        os << d.n();
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template<class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits>&
+    operator>>(std::basic_istream<CharT, Traits>& is,
+               student_t_distribution& d) {
+        auto flags = is.flags(std::ios_base::dec | std::ios_base::skipws);
+        RealType n;
+        if (is >> n)
+            d.param(param_type(n));
+        is.flags(flags);
+        return is;
+    }
+
+private:
+    param_type params_;
+    detail::standard_normal<RealType, W, N> z_;
+    gamma_type gamma_;
+};
+
+} // namespace etf
+
+#endif // ETF_STUDENT_T_HPP
@@ -0,0 +1,409 @@
+#ifndef ETF_TABLE_HPP
+#define ETF_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Table layout with the abscissae and the per-interval data stored in
+/// separate arrays.
+///
+/// This is the most compact layout, but a fast path sample typically touches
+/// two cache lines.
+///
+struct split_layout {};
+
+
+/// Table layout with all data relative to a sub-interval stored in a single,
+/// aligned table entry.
+///
+/// Each entry contains the left abscissa, the width and the scaled data of the
+/// sub-interval and is aligned to 32 or 64 bytes so that it never straddles a
+/// cache line. The tables are larger than with `split_layout` but fast path
+/// and wedge samples only touch a single cache line.
+///
+/// With single precision and W<=32, the width is omitted so that entries fit
+/// in 16 bytes; wedge samples then also read the abscissa of the next entry.
+///
+struct packed_layout {};
+
+
+namespace detail {
+
+template<typename T>
+struct aligned_allocator;
+
+template<typename T>
+class shared_array;
+
+} // namespace detail
+
+
+/// Table storage policy with tables allocated on the heap.
+///
+/// Distribution objects are small but each table access requires an
+/// indirection through a heap pointer.
+///
+struct heap_storage
+{
+    template<typename T, std::size_t Size>
+    using array = std::vector<T, detail::aligned_allocator<T>>;
+};
+
+
+/// Table storage policy with tables stored inline in the distribution object.
+///
+/// Construction requires no heap allocation and no indirection is needed to
+/// access the tables, but distribution objects are large: they are best given
+/// static storage duration or created on the stack.
+///
+struct inline_storage
+{
+    template<typename T, std::size_t Size>
+    using array = std::array<T, Size>;
+};
+
+
+/// Table storage policy with immutable tables shared between copies.
+///
+/// The tables are allocated on the heap when the distribution is constructed
+/// and are never modified afterwards. Copies of the distribution object share
+/// the tables through a reference count: they only copy a pointer per table,
+/// and objects sampled concurrently by several threads keep a single copy of
+/// the tables in the cache. Table accesses require the same indirection as
+/// with `heap_storage`.
+///
+struct shared_storage
+{
+    template<typename T, std::size_t Size>
+    using array = detail::shared_array<T>;
+};
+
+
+namespace detail {
+
+// Alignment of a packed table entry of the specified size: the smallest power
+// of 2 greater or equal to the size, up to 64 bytes.
+constexpr std::size_t packed_alignment(std::size_t size, std::size_t a = 1) {
+    return (a>=size || a>=64) ? a : packed_alignment(size, 2*a);
+}
+
+
+// Minimal allocator honoring the alignment of over-aligned types.
+template<typename T>
+struct aligned_allocator
+{
+    using value_type = T;
+
+    aligned_allocator() = default;
+
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        constexpr std::size_t A = alignof(T);
+        if (n>(std::numeric_limits<std::size_t>::max() - A)/sizeof(T))
+            throw std::bad_alloc();
+        // Over-allocate and store the original address just before the
+        // aligned block.
+        char* p = static_cast<char*>(
+            ::operator new(n*sizeof(T) + A - 1 + sizeof(void*)));
+        std::uintptr_t q = (reinterpret_cast<std::uintptr_t>(p) +
+                            sizeof(void*) + A - 1) & ~std::uintptr_t(A - 1);
+        reinterpret_cast<void**>(q)[-1] = p;
+        return reinterpret_cast<T*>(q);
+    }
+
+    void deallocate(T* q, std::size_t) {
+        ::operator delete(reinterpret_cast<void**>(q)[-1]);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const aligned_allocator<T>&, const aligned_allocator<U>&) {
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const aligned_allocator<T>&, const aligned_allocator<U>&) {
+    return false;
+}
+
+
+// Resizes a heap-allocated array.
+template<typename T, class Allocator>
+void resize_array(std::vector<T, Allocator>& a, std::size_t n) {
+    a.resize(n);
+}
+
+// No-op overload for inline arrays.
+template<typename T, std::size_t Size>
+void resize_array(std::array<T, Size>&, std::size_t) {}
+
+
+// Heap array shared between copies.
+//
+// Elements are only modified after a call to `reset()`, which always
+// allocates a new array, so that an array is never modified once shared.
+template<typename T>
+class shared_array
+{
+public:
+    void reset(std::size_t n) {
+        T* p = aligned_allocator<T>().allocate(n);
+        for (std::size_t i=0; i!=n; ++i)
+            ::new (p + i) T();
+        // The deleter is called if the control block cannot be allocated.
+        owner_ = std::shared_ptr<const T>(p, deleter{n});
+        data_ = p;
+    }
+
+    const T* data() const {
+        return data_;
+    }
+
+    T& operator[](std::size_t i) {
+        return data_[i];
+    }
+
+    const T& operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+private:
+    struct deleter
+    {
+        std::size_t n;
+
+        void operator()(const T* p) const {
+            aligned_allocator<T>().deallocate(const_cast<T*>(p), n);
+        }
+    };
+
+    std::shared_ptr<const T> owner_;
+    T* data_ = nullptr;
+};
+
+// Allocates a new, unshared array.
+template<typename T>
+void resize_array(shared_array<T>& a, std::size_t n) {
+    a.reset(n);
+}
+
+
+// Array with a size only known at run time.
+//
+// Such arrays cannot be stored inline, so they are allocated on the heap
+// unless the tables are shared.
+template<class Storage, typename T>
+struct runtime_array
+{
+    using type = std::vector<T, aligned_allocator<T>>;
+};
+
+template<typename T>
+struct runtime_array<shared_storage, T>
+{
+    using type = shared_array<T>;
+};
+
+
+// ETF tables.
+//
+// The tables hold, for each of the 2^N sub-intervals, the left abscissa, the
+// width and a table entry with the scaled data of the sub-interval.
+// Abscissae must be set with `set_x()` in increasing index order, from 0 to
+// 2^N included.
+template<typename RealType, typename UIntType, std::size_t N,
+         class Layout, class Storage>
+class table;
+
+
+// Tables with separate abscissa and data arrays.
+template<typename RealType, typename UIntType, std::size_t N, class Storage>
+class table<RealType, UIntType, N, split_layout, Storage>
+{
+public:
+    struct entry
+    {
+        UIntType scaled_fratio;
+        RealType scaled_fsup;
+        RealType scaled_dx;
+    };
+
+    static constexpr std::size_t size = std::size_t(1) << N;
+    static constexpr std::size_t x_stride = sizeof(RealType);
+    static constexpr std::size_t footprint =
+        (size + 1)*sizeof(RealType) + size*sizeof(entry);
+    static constexpr bool shared = std::is_same<Storage, shared_storage>::value;
+
+    void resize() {
+        resize_array(x_, size + 1);
+        resize_array(entries_, size);
+    }
+
+    void set_x(std::size_t i, RealType x) {
+        x_[i] = x;
+    }
+
+    RealType x(std::size_t i) const {
+        return x_[i];
+    }
+
+    RealType width(std::size_t i) const {
+        return x_[i+1] - x_[i];
+    }
+
+    RealType x_first() const {
+        return x_[0];
+    }
+
+    RealType x_last() const {
+        return x_[size];
+    }
+
+    const RealType* x_data() const {
+        return x_.data();
+    }
+
+    entry& operator[](std::size_t i) {
+        return entries_[i];
+    }
+
+    const entry& operator[](std::size_t i) const {
+        return entries_[i];
+    }
+
+private:
+    typename Storage::template array<RealType, size + 1> x_;
+    typename Storage::template array<entry, size> entries_;
+};
+
+
+// Whether packed table entries store the sub-interval width.
+//
+// The width is omitted if this makes it possible to fit an entry in 16 bytes,
+// which is the case for single precision and W<=32. The width is then
+// computed from the abscissa of the next entry, which only needs to be
+// accessed on the wedge path.
+template<typename RealType, typename UIntType>
+constexpr bool packed_has_width() {
+    return 3*sizeof(RealType) + sizeof(UIntType) > 16;
+}
+
+
+// Fields of a packed table entry, ordered by order of access on the fast
+// path.
+template<typename RealType, typename UIntType,
+         bool HasWidth = packed_has_width<RealType, UIntType>()>
+struct packed_fields
+{
+    UIntType scaled_fratio;
+    RealType x;
+    RealType scaled_dx;
+    RealType scaled_fsup;
+    RealType width;
+};
+
+template<typename RealType, typename UIntType>
+struct packed_fields<RealType, UIntType, false>
+{
+    UIntType scaled_fratio;
+    RealType x;
+    RealType scaled_dx;
+    RealType scaled_fsup;
+};
+
+
+// Tables with interleaved abscissae and data.
+template<typename RealType, typename UIntType, std::size_t N, class Storage>
+class table<RealType, UIntType, N, packed_layout, Storage>
+{
+private:
+    using fields = packed_fields<RealType, UIntType>;
+    using has_width = std::integral_constant<bool,
+        packed_has_width<RealType, UIntType>()>;
+
+public:
+    struct alignas(packed_alignment(sizeof(fields))) entry : fields {};
+
+    static constexpr std::size_t size = std::size_t(1) << N;
+    static constexpr std::size_t x_stride = sizeof(entry);
+    static constexpr std::size_t footprint = size*sizeof(entry);
+    static constexpr bool shared = std::is_same<Storage, shared_storage>::value;
+
+    void resize() {
+        resize_array(entries_, size);
+    }
+
+    void set_x(std::size_t i, RealType x) {
+        if (i!=0)
+            set_width(i-1, x - entries_[i-1].x, has_width());
+        if (i!=size)
+            entries_[i].x = x;
+        else
+            x_last_ = x;
+    }
+
+    RealType x(std::size_t i) const {
+        return entries_[i].x;
+    }
+
+    RealType width(std::size_t i) const {
+        return width(i, has_width());
+    }
+
+    RealType x_first() const {
+        return entries_[0].x;
+    }
+
+    RealType x_last() const {
+        return x_last_;
+    }
+
+    const RealType* x_data() const {
+        return &entries_[0].x;
+    }
+
+    entry& operator[](std::size_t i) {
+        return entries_[i];
+    }
+
+    const entry& operator[](std::size_t i) const {
+        return entries_[i];
+    }
+
+private:
+    void set_width(std::size_t i, RealType w, std::true_type) {
+        entries_[i].width = w;
+    }
+
+    void set_width(std::size_t, RealType, std::false_type) {}
+
+    RealType width(std::size_t i, std::true_type) const {
+        return entries_[i].width;
+    }
+
+    RealType width(std::size_t i, std::false_type) const {
+        return (i + 1!=size ? entries_[i+1].x : x_last_) - entries_[i].x;
+    }
+
+    typename Storage::template array<entry, size> entries_;
+    RealType x_last_;
+};
+
+} // namespace detail
+
+} // namespace etf
+
+#endif // ETF_TABLE_HPP
@@ -0,0 +1,490 @@
+#ifndef ETF_TABLE_CACHE_HPP
+#define ETF_TABLE_CACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define ETF_TABLE_CACHE_MMAP 1
+#endif
+
+#include "exceptions.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Header of a partition file.
+//
+// The header is followed by the parameters, the abscissae, the infima and the
+// suprema, all stored as native floating point numbers. The checksum is the
+// 64-bit FNV-1a hash of the whole file, computed with a zero checksum field.
+struct partition_file_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t real_size;
+    std::uint32_t real_digits;
+    std::uint32_t w;
+    std::uint32_t n;
+    std::uint64_t nb_params;
+    std::uint64_t nb_intervals;
+    std::uint64_t checksum;
+    char reserved[8];
+};
+
+static_assert(sizeof(partition_file_header)==64,
+              "unexpected partition file header size");
+
+constexpr char partition_file_magic[8] = {'E', 'T', 'F', 'P', 'A', 'R', 'T',
+                                          '\0'};
+constexpr std::uint32_t partition_file_version = 1;
+constexpr std::uint32_t partition_file_byte_order = 0x01020304;
+
+
+// 64-bit FNV-1a hash.
+inline std::uint64_t fnv1a(const void* data, std::size_t size,
+                           std::uint64_t h = 0xcbf29ce484222325ULL) {
+    auto p = static_cast<const unsigned char*>(data);
+    for (std::size_t i=0; i!=size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+
+// Checksum of a partition file image.
+inline std::uint64_t partition_file_checksum(const char* data,
+                                             std::size_t size) {
+    partition_file_header header;
+    std::memcpy(&header, data, sizeof(header));
+    header.checksum = 0;
+    std::uint64_t h = fnv1a(&header, sizeof(header));
+    return fnv1a(data + sizeof(header), size - sizeof(header), h);
+}
+
+
+// Size of a partition file image in units of RealType.
+template<typename RealType>
+std::size_t partition_file_length(std::size_t nb_params,
+                                  std::size_t nb_intervals) {
+    return sizeof(partition_file_header)/sizeof(RealType)
+         + nb_params + 3*nb_intervals + 1;
+}
+
+
+// Creates a partition file image.
+//
+// The image is stored in an array of RealType to guarantee the alignment of
+// the floating point data.
+template<typename RealType>
+std::vector<RealType> make_partition_file_image(
+    std::size_t W, std::size_t N,
+    const partition_data<RealType>& p,
+    const std::vector<RealType>& params) {
+    static_assert(sizeof(partition_file_header)%sizeof(RealType)==0,
+                  "unsupported floating point type size");
+
+    const std::size_t nb_intervals = p.x.empty() ? 0 : p.x.size() - 1;
+    if (p.finf.size()!=nb_intervals || p.fsup.size()!=nb_intervals)
+        throw table_cache_error("inconsistent partition");
+
+    std::vector<RealType> image(
+        partition_file_length<RealType>(params.size(), nb_intervals));
+    auto data = reinterpret_cast<char*>(image.data());
+
+    partition_file_header header = {};
+    std::memcpy(header.magic, partition_file_magic, sizeof(header.magic));
+    header.version = partition_file_version;
+    header.byte_order = partition_file_byte_order;
+    header.real_size = sizeof(RealType);
+    header.real_digits = std::numeric_limits<RealType>::digits;
+    header.w = static_cast<std::uint32_t>(W);
+    header.n = static_cast<std::uint32_t>(N);
+    header.nb_params = params.size();
+    header.nb_intervals = nb_intervals;
+    std::memcpy(data, &header, sizeof(header));
+
+    RealType* r = image.data() + sizeof(header)/sizeof(RealType);
+    r = std::copy(params.begin(), params.end(), r);
+    r = std::copy(p.x.begin(), p.x.end(), r);
+    if (p.x.empty())
+        *r++ = RealType(0);
+    r = std::copy(p.finf.begin(), p.finf.end(), r);
+    std::copy(p.fsup.begin(), p.fsup.end(), r);
+
+    header.checksum = partition_file_checksum(data,
+                                              image.size()*sizeof(RealType));
+    std::memcpy(data, &header, sizeof(header));
+
+    return image;
+}
+
+
+// Checks a partition file image and its key.
+template<typename RealType>
+void check_partition_file_image(const char* data, std::size_t size,
+                                std::size_t W, std::size_t N,
+                                const std::vector<RealType>& params) {
+    partition_file_header header;
+    if (size<sizeof(header))
+        throw table_cache_error("truncated partition file");
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, partition_file_magic, sizeof(header.magic)))
+        throw table_cache_error("not a partition file");
+    if (header.version!=partition_file_version)
+        throw table_cache_error("unsupported partition file version");
+    if (header.byte_order!=partition_file_byte_order)
+        throw table_cache_error("partition file byte order mismatch");
+    if (header.real_size!=sizeof(RealType) ||
+        header.real_digits!=std::numeric_limits<RealType>::digits)
+        throw table_cache_error("partition file floating point type mismatch");
+    if (header.w!=W || header.n!=N)
+        throw table_cache_error("partition file W or N mismatch");
+    if (header.nb_params!=params.size())
+        throw table_cache_error("partition file parameters mismatch");
+
+    const std::size_t max_intervals = size/(3*sizeof(RealType));
+    if (header.nb_intervals>max_intervals ||
+        size!=sizeof(RealType)*partition_file_length<RealType>(
+                 params.size(), header.nb_intervals))
+        throw table_cache_error("truncated partition file");
+
+    if (header.checksum!=partition_file_checksum(data, size))
+        throw table_cache_error("partition file checksum mismatch");
+
+    if (!params.empty() &&
+        std::memcmp(data + sizeof(header), params.data(),
+                    params.size()*sizeof(RealType)))
+        throw table_cache_error("partition file parameters mismatch");
+}
+
+} // namespace detail
+
+
+/// Writes a partition to a file.
+///
+/// The partition is stored together with the `W` and `N` parameters of the
+/// distribution it is intended for, the floating point type and an arbitrary
+/// sequence of parameters (e.g. the distribution parameters and the tail
+/// position), which together form the key checked when the file is loaded.
+///
+/// The file is first written under a temporary name and then renamed, so
+/// that concurrent readers never see a partially written file.
+///
+/// A `table_cache_error` is thrown if the partition is empty (i.e. if the
+/// partition solver did not converge) or if the file cannot be written.
+///
+template<typename RealType, class InputIt>
+void save_partition(const std::string& path,
+                    std::size_t W, std::size_t N,
+                    const partition_data<RealType>& p,
+                    InputIt params_first, InputIt params_last) {
+    if (p.x.empty())
+        throw table_cache_error("empty partition");
+
+    std::vector<RealType> params(params_first, params_last);
+    std::vector<RealType> image =
+        detail::make_partition_file_image(W, N, p, params);
+
+    std::string tmp_path = path + ".tmp";
+#ifdef ETF_TABLE_CACHE_MMAP
+    tmp_path += std::to_string(static_cast<long long>(::getpid()));
+#endif
+    {
+        std::ofstream file(tmp_path.c_str(),
+                           std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(image.data()),
+                   static_cast<std::streamsize>(image.size()*sizeof(RealType)));
+        file.close();
+        if (!file) {
+            std::remove(tmp_path.c_str());
+            throw table_cache_error("cannot write partition file");
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str())!=0) {
+        std::remove(tmp_path.c_str());
+        throw table_cache_error("cannot write partition file");
+    }
+}
+
+
+/// Writes a partition to a file.
+///
+/// This overload takes the parameters as an initializer list.
+///
+template<typename RealType>
+void save_partition(const std::string& path,
+                    std::size_t W, std::size_t N,
+                    const partition_data<RealType>& p,
+                    std::initializer_list<RealType> params = {}) {
+    save_partition(path, W, N, p, params.begin(), params.end());
+}
+
+
+/// Read-only view of a partition stored in a file.
+///
+/// The file is memory-mapped where supported (POSIX platforms) so that
+/// loading does not copy the data and processes which map the same file
+/// share the same physical pages; on other platforms, the file is read into
+/// memory.
+///
+/// The `x_begin()`, `x_end()`, `finf_begin()` and `fsup_begin()` members can
+/// be passed directly to distribution constructors.
+///
+template<typename RealType>
+class mapped_partition
+{
+public:
+    /// Maps a partition file.
+    ///
+    /// A `table_cache_error` is thrown if the file cannot be read, if it is
+    /// corrupted, or if its key (`W`, `N`, floating point type and
+    /// parameters) does not match the specified key.
+    ///
+    template<class InputIt>
+    mapped_partition(const std::string& path,
+                     std::size_t W, std::size_t N,
+                     InputIt params_first, InputIt params_last) {
+        std::vector<RealType> params(params_first, params_last);
+        map(path);
+        try {
+            detail::check_partition_file_image(data_, size_, W, N, params);
+        }
+        catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    /// Maps a partition file.
+    ///
+    /// This overload takes the parameters as an initializer list.
+    ///
+    mapped_partition(const std::string& path,
+                     std::size_t W, std::size_t N,
+                     std::initializer_list<RealType> params = {})
+    : mapped_partition(path, W, N, params.begin(), params.end()) {}
+
+    /// Creates an in-memory image of a partition.
+    ///
+    template<class InputIt>
+    mapped_partition(std::size_t W, std::size_t N,
+                     const partition_data<RealType>& p,
+                     InputIt params_first, InputIt params_last)
+    : owned_(detail::make_partition_file_image(
+          W, N, p, std::vector<RealType>(params_first, params_last))) {
+        data_ = reinterpret_cast<const char*>(owned_.data());
+        size_ = owned_.size()*sizeof(RealType);
+    }
+
+    mapped_partition(const mapped_partition&) = delete;
+
+    mapped_partition& operator=(const mapped_partition&) = delete;
+
+    mapped_partition(mapped_partition&& other) noexcept
+    : data_(other.data_), size_(other.size_), mapped_(other.mapped_),
+      owned_(std::move(other.owned_)) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+    }
+
+    mapped_partition& operator=(mapped_partition&& other) noexcept {
+        if (this!=&other) {
+            unmap();
+            data_ = other.data_;
+            size_ = other.size_;
+            mapped_ = other.mapped_;
+            owned_ = std::move(other.owned_);
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.mapped_ = false;
+        }
+        return *this;
+    }
+
+    ~mapped_partition() {
+        unmap();
+    }
+
+    /// Returns the number of sub-intervals.
+    ///
+    std::size_t size() const {
+        return static_cast<std::size_t>(header().nb_intervals);
+    }
+
+    /// Returns the `W` parameter of the key.
+    ///
+    std::size_t w() const {
+        return header().w;
+    }
+
+    /// Returns the `N` parameter of the key.
+    ///
+    std::size_t n() const {
+        return header().n;
+    }
+
+    /// Returns the parameters of the key.
+    ///
+    const RealType* params_begin() const {
+        return reals();
+    }
+
+    const RealType* params_end() const {
+        return reals() + header().nb_params;
+    }
+
+    /// Returns the abscissae of the partition.
+    ///
+    const RealType* x_begin() const {
+        return params_end();
+    }
+
+    const RealType* x_end() const {
+        return x_begin() + size() + 1;
+    }
+
+    /// Returns the infima over each sub-interval.
+    ///
+    const RealType* finf_begin() const {
+        return x_end();
+    }
+
+    /// Returns the suprema over each sub-interval.
+    ///
+    const RealType* fsup_begin() const {
+        return finf_begin() + size();
+    }
+
+    /// Returns a copy of the partition.
+    ///
+    partition_data<RealType> partition() const {
+        partition_data<RealType> p;
+        p.x.assign(x_begin(), x_end());
+        p.finf.assign(finf_begin(), finf_begin() + size());
+        p.fsup.assign(fsup_begin(), fsup_begin() + size());
+        return p;
+    }
+
+private:
+    const detail::partition_file_header& header() const {
+        return *reinterpret_cast<const detail::partition_file_header*>(data_);
+    }
+
+    const RealType* reals() const {
+        return reinterpret_cast<const RealType*>(
+            data_ + sizeof(detail::partition_file_header));
+    }
+
+    void map(const std::string& path) {
+#ifdef ETF_TABLE_CACHE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd<0)
+            throw table_cache_error("cannot open partition file");
+        struct stat st;
+        if (::fstat(fd, &st)!=0 || st.st_size<=0) {
+            ::close(fd);
+            throw table_cache_error("cannot read partition file");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr==MAP_FAILED)
+            throw table_cache_error("cannot map partition file");
+        data_ = static_cast<const char*>(addr);
+        mapped_ = true;
+#else
+        std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!file)
+            throw table_cache_error("cannot open partition file");
+        size_ = static_cast<std::size_t>(file.tellg());
+        owned_.resize((size_ + sizeof(RealType) - 1)/sizeof(RealType));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(owned_.data()),
+                  static_cast<std::streamsize>(size_));
+        if (!file)
+            throw table_cache_error("cannot read partition file");
+        data_ = reinterpret_cast<const char*>(owned_.data());
+#endif
+    }
+
+    void unmap() {
+#ifdef ETF_TABLE_CACHE_MMAP
+        if (mapped_)
+            ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+        owned_.clear();
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<RealType> owned_;
+};
+
+
+/// Returns a partition from a cache file, computing it if necessary.
+///
+/// If the cache file exists and matches the specified key, it is mapped and
+/// returned. Otherwise, the partition is computed by calling `build()`, which
+/// must return a `partition_data<RealType>` object, and is written to the
+/// cache file for later use. If the cache file cannot be written, an in-memory
+/// image of the computed partition is returned.
+///
+/// A `partition_convergence_error` exception is thrown if `build()` returns
+/// an empty partition, i.e. if the partition solver did not converge.
+///
+template<typename RealType, class Builder>
+mapped_partition<RealType> cached_partition(
+    const std::string& path,
+    std::size_t W, std::size_t N,
+    std::initializer_list<RealType> params,
+    Builder build) {
+    try {
+        return mapped_partition<RealType>(path, W, N, params);
+    }
+    catch (const table_cache_error&) {
+        // Missing, stale or corrupted cache file: rebuild it.
+    }
+
+    const partition_data<RealType> p = build();
+    if (p.x.empty())
+        throw partition_convergence_error();
+    try {
+        save_partition(path, W, N, p, params.begin(), params.end());
+        return mapped_partition<RealType>(path, W, N, params);
+    }
+    catch (const table_cache_error&) {
+        return mapped_partition<RealType>(W, N, p,
+                                          params.begin(), params.end());
+    }
+}
+
+} // namespace etf
+
+#endif // ETF_TABLE_CACHE_HPP
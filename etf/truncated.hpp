@@ -0,0 +1,368 @@
+#ifndef ETF_TRUNCATED_HPP
+#define ETF_TRUNCATED_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "implementation.hpp"
+#include "random_digits.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+namespace detail {
+
+// Traits of the builder base class of an ETF distribution.
+template<class Builder>
+struct builder_traits;
+
+template<typename RealType, std::size_t W, std::size_t N, class Shape>
+struct builder_traits<builder<RealType, W, N, Shape>>
+{
+    using real_type = RealType;
+    static constexpr std::size_t w = W;
+    static constexpr std::size_t n = N;
+};
+
+
+// Returns the builder base class of an ETF distribution.
+template<typename RealType, std::size_t W, std::size_t N, class Shape>
+const builder<RealType, W, N, Shape>& as_builder(
+    const builder<RealType, W, N, Shape>& d) {
+    return d;
+}
+
+} // namespace detail
+
+
+/// Truncated view of an ETF distribution.
+///
+/// Generates variates of an ETF distribution conditioned on the interval
+/// [`a`, `b`], using the tables of the viewed distribution. No tables are
+/// computed when the view is created, so that creating a view for each
+/// interval is cheap.
+///
+/// The portion of the interval covered by the table is sampled by drawing a
+/// point uniformly in the upper rectangles overlapping the interval, the
+/// end rectangles being clipped to the interval, and by accepting it if it
+/// lies below the infimum of its rectangle or, failing that, below the
+/// density. The sampling efficiency thus does not degrade for narrow
+/// intervals, except close to a zero of the density where it is the ratio of
+/// the density to the supremum of its rectangle. The portions of the
+/// interval outside the table, if any, are sampled by rejection from a
+/// rectangle bounded by the largest of the densities at their ends if they
+/// are finite, or else from the outer distribution, whose samples falling
+/// in a portion sampled from a rectangle are then rejected.
+///
+/// The density must be monotonic over finite portions of the interval
+/// outside the table, as is the case for the tails of unimodal
+/// distributions. The sampling efficiency of an infinite portion is the
+/// probability of the interval relatively to that of the outer distribution,
+/// so intervals in the far tail should be given a finite bound.
+///
+/// The view holds a reference to the distribution, which must outlive it.
+/// Variates are generated with the const sampling path of the distribution
+/// and the view can be used concurrently by several threads, each passing
+/// its own generator.
+///
+template<class Distribution>
+class truncated_distribution
+{
+private:
+    using Builder = typename std::remove_const<
+        typename std::remove_reference<
+            decltype(detail::as_builder(std::declval<const Distribution&>()))
+        >::type>::type;
+    using Traits = detail::builder_traits<Builder>;
+    using RealType = typename Traits::real_type;
+    using UIntType = typename Builder::UIntType;
+
+    static constexpr std::size_t W = Traits::w;
+    static constexpr std::size_t N = Traits::n;
+    static constexpr std::size_t S = Builder::IsSymmetric ? 1 : 0;
+    static constexpr std::size_t n = std::size_t(1) << N;
+    static constexpr std::size_t nb_slots = n << S;
+
+public:
+    using result_type = RealType;
+
+    /// Creates a view of distribution `d` truncated to [`a`, `b`].
+    ///
+    /// An `std::invalid_argument` exception is thrown if `a` is not lower
+    /// than `b` or if the distribution has no mass on [`a`, `b`].
+    ///
+    truncated_distribution(const Distribution& d, RealType a, RealType b)
+    : d_(&d), a_(a), b_(b) {
+        if (!(a<b))
+            throw std::invalid_argument("invalid truncation interval");
+
+        const Builder& e = detail::as_builder(d);
+        const auto& table = e.table_;
+        increasing_ = table.x_first()<table.x_last();
+
+        // All weights are areas relative to that of an upper rectangle.
+        const RealType outer_switch = Builder::HasOuter ?
+            static_cast<RealType>(e.outer_switch())
+          : static_cast<RealType>(UIntType(1) << (W - N - S));
+        outer_switch_ = outer_switch;
+        inv_outer_switch_ = RealType(1)/outer_switch;
+        area_ = std::abs(table.width(0))*table[0].scaled_fsup*outer_switch;
+
+        // Portion covered by the table.
+        s_first_ = slot_coordinate(a);
+        w_body_ = slot_coordinate(b) - s_first_;
+
+        // Portions outside the table.
+        body_lo_ = slot_lo(0);
+        body_hi_ = slot_hi(nb_slots - 1);
+        w_left_ = 0;
+        w_right_ = 0;
+        w_outer_ = 0;
+        if (Builder::HasOuter) {
+            const RealType p_body = outer_switch
+                / static_cast<RealType>(UIntType(1) << (W - N - S));
+            const RealType w_outer = static_cast<RealType>(nb_slots)
+                * (RealType(1) - p_body)/p_body;
+            bool use_outer = false;
+            if (a<body_lo_)
+                use_outer |= !envelope(a, std::min(b, body_lo_), w_outer,
+                                       left_lo_, left_width_, left_height_,
+                                       w_left_);
+            if (b>body_hi_)
+                use_outer |= !envelope(std::max(a, body_hi_), b, w_outer,
+                                       right_lo_, right_width_,
+                                       right_height_, w_right_);
+            if (use_outer)
+                w_outer_ = w_outer;
+        }
+
+        w_total_ = w_body_ + w_left_ + w_right_ + w_outer_;
+        if (!(w_total_>RealType(0)))
+            throw std::invalid_argument("empty truncation interval");
+    }
+
+    /// Returns a random number.
+    ///
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        const Builder& e = detail::as_builder(*d_);
+        while (true) {
+            RealType u = generate_random_real<RealType, W>(g)*w_total_;
+            RealType x;
+            if (u<w_body_) {
+                // Clipped upper rectangles.
+                RealType s = s_first_ + u;
+                auto j = static_cast<std::size_t>(s);
+                if (j>=nb_slots)
+                    continue;
+                int sign;
+                std::size_t i = box(j, sign);
+                RealType lo = slot_lo(j);
+                x = lo + (s - static_cast<RealType>(j))*(slot_hi(j) - lo);
+                if (x<a_ || x>b_)
+                    continue;
+                // Accept below the infimum, otherwise test y<f(x).
+                const auto& entry = e.table_[i];
+                RealType v = generate_random_real<RealType, W>(g);
+                if (v<static_cast<RealType>(entry.scaled_fratio)
+                      *inv_outer_switch_)
+                    return x;
+                RealType y = v*entry.scaled_fsup*outer_switch_;
+                if (y<e.func_(e.origin() + sign*(x - e.origin())))
+                    return x;
+                continue;
+            }
+            u -= w_body_;
+            if (u<w_left_ + w_right_) {
+                // Rectangle envelopes outside the table.
+                bool left = u<w_left_;
+                RealType t = left ? u/w_left_ : (u - w_left_)/w_right_;
+                x = left ? left_lo_ + t*left_width_
+                         : right_lo_ + t*right_width_;
+                RealType y = generate_random_real<RealType, W>(g)
+                           * (left ? left_height_ : right_height_);
+                if (x>=a_ && x<=b_ && y<density(x))
+                    return x;
+                continue;
+            }
+            // Outer distribution, restricted to the portions which have no
+            // rectangle envelope.
+            if (sample_outer(g, x) && x>=a_ && x<=b_
+                && !(w_left_>RealType(0) && x<body_lo_)
+                && !(w_right_>RealType(0) && x>body_hi_))
+                return x;
+        }
+    }
+
+    /// Fills a range with random numbers.
+    ///
+    template<class ForwardIt, class RngType>
+    void generate(ForwardIt first, ForwardIt last, RngType& g) const {
+        for (; first!=last; ++first)
+            *first = (*this)(g);
+    }
+
+    void reset() {}
+
+    /// Returns the lower bound of the interval.
+    ///
+    RealType a() const { return a_; }
+
+    /// Returns the upper bound of the interval.
+    ///
+    RealType b() const { return b_; }
+
+    result_type min() const { return a_; }
+
+    result_type max() const { return b_; }
+
+    /// Returns the viewed distribution.
+    ///
+    const Distribution& distribution() const { return *d_; }
+
+private:
+    // Returns the table index and the sign of the slot with index `j`, the
+    // slots being sorted by increasing abscissae.
+    std::size_t box(std::size_t j, int& sign) const {
+        sign = 1;
+        if (S==1) {
+            if (j<n) {
+                sign = -1;
+                return increasing_ ? n - 1 - j : j;
+            }
+            j -= n;
+        }
+        return increasing_ ? j : n - 1 - j;
+    }
+
+    // Returns the bounds of the slot with index `j`.
+    RealType slot_lo(std::size_t j) const {
+        return slot_bound(j, true);
+    }
+
+    RealType slot_hi(std::size_t j) const {
+        return slot_bound(j, false);
+    }
+
+    RealType slot_bound(std::size_t j, bool lower) const {
+        const Builder& e = detail::as_builder(*d_);
+        int sign;
+        std::size_t i = box(j, sign);
+        RealType x0 = e.table_.x(i);
+        RealType x1 = x0 + e.table_.width(i);
+        std::pair<RealType, RealType> mm = std::minmax(x0, x1);
+        RealType x = (sign>0)==lower ? mm.first : mm.second;
+        return e.origin() + sign*x;
+    }
+
+    // Returns the slot coordinate of an abscissa, i.e. the index of the
+    // slot containing it plus its relative position within the slot, clamped
+    // to the range of the table.
+    RealType slot_coordinate(RealType x) const {
+        std::size_t lo = 0;
+        std::size_t hi = nb_slots;
+        while (lo!=hi) {
+            std::size_t mid = lo + (hi - lo)/2;
+            if (slot_hi(mid)>x)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        if (lo==nb_slots)
+            return static_cast<RealType>(nb_slots);
+        RealType x0 = slot_lo(lo);
+        RealType t = x>x0 ? (x - x0)/(slot_hi(lo) - x0) : RealType(0);
+        return static_cast<RealType>(lo) + t;
+    }
+
+    // Returns the density at an abscissa.
+    RealType density(RealType x) const {
+        const Builder& e = detail::as_builder(*d_);
+        RealType o = e.origin();
+        return e.func_(S==1 ? o + std::abs(x - o) : x);
+    }
+
+    // Computes a rectangle envelope of the density over [lo, hi] and its
+    // weight, and returns false if it is infinite or heavier than the outer
+    // distribution.
+    bool envelope(RealType lo, RealType hi, RealType w_outer,
+                  RealType& rect_lo, RealType& rect_width,
+                  RealType& rect_height, RealType& w) const {
+        rect_lo = lo;
+        rect_width = hi - lo;
+        rect_height = std::max(density(lo), density(hi));
+        w = rect_width*rect_height/area_;
+        if (std::isfinite(w) && w<=w_outer)
+            return true;
+        w = 0;
+        return false;
+    }
+
+    // Draws a candidate from the outer distribution and returns true if it
+    // is accepted.
+    template<class RngType>
+    bool sample_outer(RngType& g, RealType& x) const {
+        return sample_outer(g, x,
+            std::integral_constant<bool, Builder::IsSelfSimilar>());
+    }
+
+    template<class RngType>
+    bool sample_outer(RngType& g, RealType& x, std::false_type) const {
+        if (!Builder::HasOuter)
+            return false;
+        const Builder& e = detail::as_builder(*d_);
+        bool accepted = e.sample_outer(g, x) || !Builder::HasRejection;
+        if (S==1 && generate_random_real<RealType, W>(g)<RealType(0.5))
+            x = 2*e.origin() - x;
+        return accepted;
+    }
+
+    template<class RngType>
+    bool sample_outer(RngType& g, RealType& x, std::true_type) const {
+        const Builder& e = detail::as_builder(*d_);
+        x = e.table_.x_last() - e.table_.x_first() + e(g);
+        return true;
+    }
+
+    const Distribution* d_;
+    RealType a_;
+    RealType b_;
+    bool increasing_;
+    RealType outer_switch_;
+    RealType inv_outer_switch_;
+    RealType area_;
+    RealType s_first_;
+    RealType w_body_;
+    RealType body_lo_;
+    RealType body_hi_;
+    RealType w_left_;
+    RealType w_right_;
+    RealType w_outer_;
+    RealType w_total_;
+    RealType left_lo_;
+    RealType left_width_;
+    RealType left_height_;
+    RealType right_lo_;
+    RealType right_width_;
+    RealType right_height_;
+};
+
+
+/// Creates a view of a distribution truncated to [`a`, `b`].
+///
+template<class Distribution, typename RealType>
+truncated_distribution<Distribution> make_truncated_distribution(
+    const Distribution& d, RealType a, RealType b) {
+    return truncated_distribution<Distribution>(d, a, b);
+}
+
+} // namespace etf
+
+#endif // ETF_TRUNCATED_HPP
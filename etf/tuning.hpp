@@ -0,0 +1,394 @@
+#ifndef ETF_TUNING_HPP
+#define ETF_TUNING_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "distribution.hpp"
+#include "exceptions.hpp"
+#include "statistics.hpp"
+#include "util.hpp"
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// Objective minimized by the tail tuner.
+///
+enum class tuning_objective {
+    time,        ///< mean wall-clock time per sample
+    engine_calls ///< mean number of calls to the random generator per sample
+};
+
+
+/// Options of the tail tuner.
+///
+struct tuning_options
+{
+    tuning_options()
+    : nb_candidates(8), nb_samples(std::size_t(1) << 20),
+      max_tail_probability_error(1e-3), objective(tuning_objective::time) {}
+
+    std::size_t nb_candidates;  ///< tail positions tried for each N
+    std::size_t nb_samples;     ///< samples drawn for each measurement
+    double max_tail_probability_error; ///< tolerance on the relative
+                                       ///< rounding error on the tail
+                                       ///< sampling probability
+    tuning_objective objective; ///< minimized quantity
+};
+
+
+/// Configuration measured by the tail tuner.
+///
+template<typename RealType>
+struct tuning_candidate
+{
+    std::size_t n;        ///< number of digits of the table index
+    RealType xtail;       ///< tail position
+    RealType tail_area;   ///< area under the function over the tail
+    RealType tail_probability_error; ///< rounding error on the tail
+                                     ///< sampling probability, relative to
+                                     ///< the tail probability
+    double fast_fraction; ///< fraction of samples taken by the fast path
+    double engine_calls;  ///< mean calls to the random generator per sample
+    double time;          ///< mean wall-clock time per sample (ns)
+};
+
+
+/// Result of a tuning run.
+///
+/// The candidates are listed by increasing N and increasing tail position.
+///
+template<typename RealType>
+struct tuning_report
+{
+    tuning_candidate<RealType> best;
+    std::vector<tuning_candidate<RealType>> candidates;
+};
+
+
+/// Writes a candidate configuration.
+///
+/// The tail position is written with enough digits to be copied verbatim
+/// into the source code.
+///
+template<typename RealType>
+std::ostream& operator<<(std::ostream& os,
+                         const tuning_candidate<RealType>& c) {
+    std::streamsize precision = os.precision();
+    os.precision(std::numeric_limits<RealType>::max_digits10);
+    os << "N=" << c.n << " xtail=" << c.xtail
+       << " tail_area=" << c.tail_area;
+    os.precision(4);
+    os << " tail_probability_error=" << c.tail_probability_error
+       << " fast_fraction=" << c.fast_fraction
+       << " engine_calls=" << c.engine_calls
+       << " time=" << c.time << "ns";
+    os.precision(precision);
+    return os;
+}
+
+
+namespace detail {
+
+// Tail tuner shared by the central and asymmetric distributions.
+//
+// The outer switch is computed with the same expression as in
+// `builder::build`, so the rounding error on the tail sampling probability
+// of each candidate is exactly that of the distribution eventually built.
+template<typename RealType, std::size_t W, bool IsCentral,
+         class Func, class DFunc, class Extrema,
+         class TailFactory, class TailAreaFunc>
+class tail_tuner
+{
+public:
+    tail_tuner(Func f, DFunc df, const Extrema& extrema,
+               TailFactory make_tail, TailAreaFunc tail_area,
+               RealType x0, RealType xtail_min, RealType xtail_max,
+               const tuning_options& options)
+    : f_(f), df_(df), extrema_(extrema), make_tail_(make_tail),
+      tail_area_(tail_area), x0_(x0), xtail_min_(xtail_min),
+      xtail_max_(xtail_max), options_(options), workspace_(0) {
+        if (!(x0<xtail_min && xtail_min<=xtail_max))
+            throw std::invalid_argument("invalid tail position range");
+        if (options.nb_candidates==0 || options.nb_samples==0)
+            throw std::invalid_argument("invalid tuning options");
+    }
+
+    // Measures the candidates for N, discarding those for which the tail
+    // sampling probability is too inaccurate.
+    template<std::size_t N, class RngType>
+    void tune(RngType& g, tuning_report<RealType>& report) {
+        for (RealType xtail : tail_positions(N)) {
+            if (tail_probability_error(N, xtail)<=
+                options_.max_tail_probability_error)
+                report.candidates.push_back(measure<N>(xtail, g));
+        }
+    }
+
+private:
+    static constexpr std::size_t S = IsCentral ? 1 : 0;
+
+    using OuterDist = typename std::decay<decltype(
+        std::declval<TailFactory&>()(std::declval<RealType>()))>::type;
+
+    template<std::size_t N, class Statistics>
+    using distribution_type = typename std::conditional<IsCentral,
+        central_distribution<RealType, W, N, Func, OuterDist, void,
+                             split_layout, heap_storage, Statistics>,
+        distribution<RealType, W, N, Func, OuterDist, void,
+                     split_layout, heap_storage, Statistics>>::type;
+
+    // Computes the partition of [x0, xtail].
+    const partition_data<RealType>& solve(std::size_t n, RealType xtail) {
+        auto x_guess = trapezoidal_rule_prepartition(f_, x0_, xtail, n);
+        const auto& p = newton_partition(workspace_, f_, df_,
+            x_guess.begin(), x_guess.end(), extrema_.begin(), extrema_.end(),
+            std::numeric_limits<RealType>::epsilon()*RealType(1e4));
+        if (p.x.empty())
+            throw partition_convergence_error();
+        return p;
+    }
+
+    // Returns the unrounded outer switch of the builder for N and `xtail`.
+    RealType outer_switch(std::size_t N, RealType xtail) {
+        const auto& p = solve(std::size_t(1) << N, xtail);
+        RealType upper_quadrature_area = 0.0;
+        for (std::size_t i=0; i!=p.fsup.size(); ++i)
+            upper_quadrature_area += (p.x[i + 1] - p.x[i])*p.fsup[i];
+        return std::ldexp(RealType(1), static_cast<int>(W - N - S)) *
+               (upper_quadrature_area/
+                (tail_area_(xtail) + upper_quadrature_area));
+    }
+
+    // Returns the rounding error on the tail sampling probability, relative
+    // to the tail probability.
+    RealType tail_probability_error(std::size_t N, RealType xtail) {
+        RealType s = outer_switch(N, xtail);
+        RealType m = std::ldexp(RealType(1), static_cast<int>(W - N - S));
+        return std::abs(std::round(s) - s)/(m - s);
+    }
+
+    // Returns the tail positions to be tried for N.
+    //
+    // The outer switch increases with the tail position. The positions of a
+    // regular grid are moved, within half a grid step, to the nearest
+    // position for which the outer switch is an integer, so that the tail
+    // sampling probability is not affected by rounding. Grid positions for
+    // which this fails are kept unchanged.
+    std::vector<RealType> tail_positions(std::size_t N) {
+        std::vector<RealType> xtails;
+        const std::size_t nb = options_.nb_candidates;
+        const RealType step = nb==1 ? xtail_max_ - xtail_min_
+            : (xtail_max_ - xtail_min_)/RealType(nb - 1);
+        RealType last_k = -1;
+        for (std::size_t j=0; j!=nb; ++j) {
+            RealType x = nb==1 ? RealType(0.5)*(xtail_min_ + xtail_max_)
+                : xtail_min_ + step*RealType(j);
+            RealType s = outer_switch(N, x);
+            RealType k = std::round(s);
+            RealType a = x;
+            RealType b = x;
+            RealType s_a = s;
+            RealType s_b = s;
+            if (s<k) {
+                b = std::min(xtail_max_, x + RealType(0.5)*step);
+                s_b = outer_switch(N, b);
+            }
+            else if (s>k) {
+                a = std::max(xtail_min_, x - RealType(0.5)*step);
+                s_a = outer_switch(N, a);
+            }
+            if (s_a<=k && k<=s_b) {
+                x = bisect(N, k, a, s_a, b, s_b);
+                if (k==last_k)
+                    continue;
+                last_k = k;
+            }
+            xtails.push_back(x);
+        }
+        return xtails;
+    }
+
+    // Returns the position within [a, b] where the outer switch is closest
+    // to `k`, given that s_a<=k<=s_b.
+    RealType bisect(std::size_t N, RealType k,
+                    RealType a, RealType s_a, RealType b, RealType s_b) {
+        while (s_a!=k && s_b!=k) {
+            RealType c = RealType(0.5)*(a + b);
+            if (c==a || c==b)
+                break;
+            RealType s_c = outer_switch(N, c);
+            if (s_c<k) {
+                a = c;
+                s_a = s_c;
+            }
+            else {
+                b = c;
+                s_b = s_c;
+            }
+        }
+        return std::abs(s_a - k)<=std::abs(s_b - k) ? a : b;
+    }
+
+    // Measures the sampling cost of a configuration.
+    template<std::size_t N, class RngType>
+    tuning_candidate<RealType> measure(RealType xtail, RngType& g) {
+        tuning_candidate<RealType> c;
+        c.n = N;
+        c.xtail = xtail;
+        c.tail_area = tail_area_(xtail);
+
+        c.tail_probability_error = tail_probability_error(N, xtail);
+
+        const auto& p = solve(std::size_t(1) << N, xtail);
+
+        // Count the sampling paths.
+        distribution_type<N, sampling_statistics> counted(p.x.begin(),
+            p.x.end(), p.finf.begin(), p.fsup.begin(), f_, make_tail_(xtail),
+            c.tail_area);
+        run(counted, g, options_.nb_samples);
+        const sampling_counters& counters = counted.statistics();
+        c.fast_fraction = double(counters.fast)/double(counters.samples);
+        c.engine_calls = double(counters.engine_calls)/
+                         double(counters.samples);
+
+        // Measure the time per sample, after a short warm-up.
+        distribution_type<N, no_statistics> timed(p.x.begin(), p.x.end(),
+            p.finf.begin(), p.fsup.begin(), f_, make_tail_(xtail),
+            c.tail_area);
+        run(timed, g, options_.nb_samples/16 + 1);
+        auto start = std::chrono::steady_clock::now();
+        run(timed, g, options_.nb_samples);
+        auto stop = std::chrono::steady_clock::now();
+        c.time = std::chrono::duration<double, std::nano>(stop - start).count()
+                 /double(options_.nb_samples);
+
+        return c;
+    }
+
+    template<class Dist, class RngType>
+    static void run(Dist& dist, RngType& g, std::size_t nb_samples) {
+        RealType sum = 0;
+        for (std::size_t k=0; k!=nb_samples; ++k)
+            sum += dist(g);
+        // Prevent the loop from being optimized away.
+        volatile RealType sink = sum;
+        (void)sink;
+    }
+
+    Func f_;
+    DFunc df_;
+    const Extrema& extrema_;
+    TailFactory make_tail_;
+    TailAreaFunc tail_area_;
+    RealType x0_;
+    RealType xtail_min_;
+    RealType xtail_max_;
+    tuning_options options_;
+    partition_workspace<RealType> workspace_;
+};
+
+
+template<typename RealType, std::size_t W, std::size_t... Ns,
+         class Tuner, class RngType>
+tuning_report<RealType> run_tuner(Tuner& tuner, RngType& g,
+                                  tuning_objective objective) {
+    static_assert(sizeof...(Ns)!=0, "at least one value of N is required");
+
+    tuning_report<RealType> report;
+    int expand[] = { (tuner.template tune<Ns>(g, report), 0)... };
+    (void)expand;
+    if (report.candidates.empty())
+        throw std::invalid_argument(
+            "no tail position meets the tail probability tolerance");
+
+    auto better = [objective](const tuning_candidate<RealType>& a,
+                              const tuning_candidate<RealType>& b) {
+        return objective==tuning_objective::time ? a.time<b.time
+            : (a.engine_calls<b.engine_calls ||
+               (a.engine_calls==b.engine_calls && a.time<b.time));
+    };
+    report.best = *std::min_element(report.candidates.begin(),
+                                    report.candidates.end(), better);
+    return report;
+}
+
+} // namespace detail
+
+
+/// Tunes the tail position and table size of a central distribution.
+///
+/// The central distribution samples `f` over [-`xtail`, `xtail`] with the ETF
+/// algorithm and the tails with the outer distribution returned by
+/// `make_tail(xtail)`, the area under `f` over [`xtail`, +inf) being
+/// `tail_area(xtail)`. Function `f` must be even and decreasing over
+/// [0, +inf); its derivative `df` may be a placeholder such as
+/// `automatic_derivative`.
+///
+/// For each of the table index digits `Ns...` provided as explicit template
+/// arguments, a number of tail positions within [`xtail_min`, `xtail_max`] are
+/// tried. These are chosen such that the tail sampling probability
+/// computed by the distribution builder is not rounded, unless no such
+/// position exists nearby; positions for which the relative rounding error
+/// exceeds the tolerance specified in the options are discarded. Each
+/// remaining configuration is then measured with the random generator `g`,
+/// and the configuration that minimizes the objective specified in the
+/// options is returned as the best candidate. An `std::invalid_argument` is
+/// thrown if all positions are discarded.
+///
+template<typename RealType, std::size_t W, std::size_t... Ns,
+         class Func, class DFunc, class TailFactory, class TailAreaFunc,
+         class RngType>
+tuning_report<RealType> tune_central_distribution(
+    Func f, DFunc df, TailFactory make_tail, TailAreaFunc tail_area,
+    RealType xtail_min, RealType xtail_max, RngType& g,
+    const tuning_options& options = tuning_options()) {
+    using Extrema = std::vector<RealType>;
+    const Extrema extrema;
+    detail::tail_tuner<RealType, W, true, Func, DFunc, Extrema,
+                       TailFactory, TailAreaFunc>
+    tuner(f, df, extrema, make_tail, tail_area, RealType(0), xtail_min,
+          xtail_max, options);
+    return detail::run_tuner<RealType, W, Ns...>(tuner, g,
+                                                 options.objective);
+}
+
+
+/// Tunes the tail position and table size of a distribution.
+///
+/// This is the counterpart of `tune_central_distribution` for a distribution
+/// sampling `f` over [`x0`, `xtail`] with the ETF algorithm and over
+/// [`xtail`, +inf) with the outer distribution. The abscissae of the inner
+/// extrema of `f` over [`x0`, `xtail_min`] are provided as an ordered
+/// container with `begin()` and `end()` members.
+///
+template<typename RealType, std::size_t W, std::size_t... Ns,
+         class Func, class DFunc, class Extrema, class TailFactory,
+         class TailAreaFunc, class RngType>
+tuning_report<RealType> tune_distribution(
+    Func f, DFunc df, const Extrema& extrema,
+    TailFactory make_tail, TailAreaFunc tail_area,
+    RealType x0, RealType xtail_min, RealType xtail_max, RngType& g,
+    const tuning_options& options = tuning_options()) {
+    detail::tail_tuner<RealType, W, false, Func, DFunc, Extrema,
+                       TailFactory, TailAreaFunc>
+    tuner(f, df, extrema, make_tail, tail_area, x0, xtail_min, xtail_max,
+          options);
+    return detail::run_tuner<RealType, W, Ns...>(tuner, g,
+                                                 options.objective);
+}
+
+} // namespace etf
+
+#endif // ETF_TUNING_HPP
@@ -2,15 +2,28 @@
 #define ETF_UTIL_HPP
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <exception>
 #include <limits>
 #include <iterator>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "derivative.hpp"
+#include "exceptions.hpp"
 #include "random_digits.hpp"
 
+// Functions that can be evaluated at compile time in C++17 and above.
+#if __cplusplus >= 201703L
+#   define ETF_CONSTEXPR17 constexpr
+#else
+#   define ETF_CONSTEXPR17
+#endif
+
 
 /// Exclusive Top Floor namespace.
 ///
@@ -19,16 +32,20 @@ namespace etf {
 namespace detail {
 
 // Beware: for efficiency the diagonal and RHS terms are modified in place.
-template<typename RealType>
-void
-solve_tridiagonal_system(const std::vector<RealType>& a,
-                         std::vector<RealType>& b,
-                         const std::vector<RealType>& c,
-                         std::vector<RealType>& rhs,
-                         std::vector<RealType>& sol) {
-    using size_type = typename std::vector<RealType>::size_type;
+//
+// The arrays may be either `std::vector`s or `std::array`s; the function is
+// `constexpr` in C++17 and above when used with `std::array`s.
+template<class Array>
+ETF_CONSTEXPR17 void
+solve_tridiagonal_system(const Array& a,
+                         Array& b,
+                         const Array& c,
+                         Array& rhs,
+                         Array& sol) {
+    using size_type = std::size_t;
+    using RealType = typename Array::value_type;
 
-    auto m = a.size();
+    size_type m = a.size();
     
     // Eliminate the sub-diagonal.
     for (size_type i=1; i!=m; ++i) {
@@ -134,6 +151,201 @@ trapezoidal_rule_prepartition(Func f,
 }
 
 
+/// Computes a partition dividing approximately evenly the upper Riemann sum of
+/// a function using an adaptive Simpson quadrature.
+///
+/// Interval [`x0`, `x1`] is first divided into `nb_intervals` regular panels,
+/// which are then recursively bisected until the Simpson quadrature of `f`
+/// over each panel is accurate to within a fraction `tol` of the total area
+/// divided by the number of panels, or until a maximum bisection depth of 20
+/// is reached, so that `f` is sampled more finely where it varies rapidly.
+///
+/// Contrarily to `trapezoidal_rule_prepartition`, the partition does not
+/// divide evenly the area under `f` but, to first order, the areas of the
+/// upper rectangles as the ETF partition does: a sub-interval of width `w`
+/// centered on `x` has an upper rectangle area of approximately
+/// `f(x)*w + |f'(x)|*w*w/2`, where the derivative is estimated from the
+/// samples. The cumulative number of sub-intervals implied by this relation
+/// is computed with the Simpson rule and inverted with a monotone piecewise
+/// cubic (PCHIP) interpolant. This usually saves Newton iterations in the
+/// final partition solver.
+/// The returned vector is the set of abscissae.
+///
+template<typename RealType, class Func>
+#if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+__attribute__ ((noinline))
+#endif
+std::vector<RealType>
+adaptive_simpson_prepartition(Func f,
+                              RealType x0,
+                              RealType x1,
+                              std::size_t nb_intervals,
+                              RealType tol = RealType(1e-6)) {
+    using size_type = typename std::vector<RealType>::size_type;
+
+    // Convenient const alias.
+    const auto& m = nb_intervals;
+
+    struct panel
+    {
+        RealType a, b, fa, fm, fb, s, eps;
+        unsigned int depth;
+    };
+    const unsigned int max_depth = 20;
+
+    // Initial regular panels and their Simpson quadratures.
+    const RealType dx = (x1 - x0)/static_cast<RealType>(m);
+    std::vector<panel> panels(m);
+    RealType fa = f(x0);
+    RealType area = 0;
+    for (size_type i=0; i!=m; ++i) {
+        auto& p = panels[i];
+        p.a = x0 + static_cast<RealType>(i)*dx;
+        p.b = (i + 1)!=m ? x0 + static_cast<RealType>(i + 1)*dx : x1;
+        p.fa = fa;
+        p.fm = f(RealType(0.5)*(p.a + p.b));
+        p.fb = f(p.b);
+        p.s = (p.b - p.a)*(p.fa + 4*p.fm + p.fb)/6;
+        p.depth = 0;
+        fa = p.fb;
+        area += p.s;
+    }
+
+    // Refine the panels depth-first, from left to right. The boundaries and
+    // midpoints of the accepted panels are recorded as knots, so that panel
+    // `k` spans knots 2k to 2k+2.
+    std::vector<RealType> xk(1, x0);
+    std::vector<RealType> fk(1, panels.front().fa);
+    std::vector<panel> stack;
+    const RealType eps = tol*area/static_cast<RealType>(m);
+    for (size_type i=0; i!=m; ++i) {
+        panels[i].eps = eps;
+        stack.push_back(panels[i]);
+        while (!stack.empty()) {
+            panel p = stack.back();
+            stack.pop_back();
+            const RealType c = RealType(0.5)*(p.a + p.b);
+            const RealType fl = f(RealType(0.5)*(p.a + c));
+            const RealType fr = f(RealType(0.5)*(c + p.b));
+            const RealType sl = (c - p.a)*(p.fa + 4*fl + p.fm)/6;
+            const RealType sr = (p.b - c)*(p.fm + 4*fr + p.fb)/6;
+            if (p.depth<max_depth && std::abs(sl + sr - p.s)>15*p.eps) {
+                panel right = { c, p.b, p.fm, fr, p.fb, sr,
+                                RealType(0.5)*p.eps, p.depth + 1 };
+                panel left = { p.a, c, p.fa, fl, p.fm, sl,
+                               RealType(0.5)*p.eps, p.depth + 1 };
+                stack.push_back(right);
+                stack.push_back(left);
+                continue;
+            }
+            xk.push_back(c);
+            fk.push_back(p.fm);
+            xk.push_back(p.b);
+            fk.push_back(p.fb);
+        }
+    }
+    const size_type nk = xk.size();
+
+    // Derivative magnitudes estimated with finite differences.
+    std::vector<RealType> dk(nk);
+    for (size_type k=0; k!=nk; ++k) {
+        size_type kl = k!=0 ? k - 1 : 0;
+        size_type kr = k + 1!=nk ? k + 1 : nk - 1;
+        dk[k] = std::abs((fk[kr] - fk[kl])/(xk[kr] - xk[kl]));
+    }
+
+    // Cumulative number of sub-intervals at the knots for an upper rectangle
+    // area `u`, the local density of sub-intervals being the inverse of the
+    // positive root `w` of `|f'|*w*w/2 + f*w - u = 0`.
+    std::vector<RealType> rho(nk);
+    std::vector<RealType> gk(nk);
+    auto count = [&](RealType u) -> RealType {
+        for (size_type k=0; k!=nk; ++k)
+            rho[k] = (fk[k] + std::sqrt(fk[k]*fk[k] + 2*dk[k]*u))/(2*u);
+        gk[0] = 0;
+        for (size_type k=0; k + 2<nk; k+=2) {
+            const RealType h = xk[k + 2] - xk[k];
+            const RealType g = h*(rho[k] + 4*rho[k + 1] + rho[k + 2])/6;
+            // Integral over the left half of the quadratic interpolant.
+            const RealType gl = h*(5*rho[k] + 8*rho[k + 1] - rho[k + 2])/24;
+            gk[k + 1] = gk[k] + std::min(std::max(gl, RealType(0)), g);
+            gk[k + 2] = gk[k] + g;
+        }
+        return gk[nk - 1];
+    };
+
+    // Solve for the upper rectangle area which yields the requested number of
+    // sub-intervals. Since the density decreases with the area and the
+    // derivative term only increases the density, the solution is at least
+    // the average area under `f`.
+    std::vector<RealType> xp(m + 1);
+    xp[0] = x0;
+    xp[m] = x1;
+    if (!(area>RealType(0))) {
+        for (size_type j=1; j<m; ++j)
+            xp[j] = x0 + static_cast<RealType>(j)*dx;
+        return xp;
+    }
+    const RealType target = static_cast<RealType>(m);
+    RealType u_lo = area/target;
+    RealType u_hi = 2*u_lo;
+    while (count(u_hi)>target)
+        u_hi *= 2;
+    for (int iter=0; iter!=100; ++iter) {
+        RealType u = std::sqrt(u_lo*u_hi);
+        if (!(u_lo<u && u<u_hi))
+            break;
+        if (count(u)>target)
+            u_lo = u;
+        else
+            u_hi = u;
+    }
+    const RealType total = count(u_hi);
+
+    // Remove the knots across which the count does not increase.
+    size_type n = 1;
+    for (size_type k=1; k!=nk; ++k) {
+        if (gk[k]>gk[n - 1]) {
+            xk[n] = xk[k];
+            gk[n] = gk[k];
+            ++n;
+        }
+    }
+
+    // Slopes of the monotone interpolant of x(g) (Fritsch-Butland).
+    std::vector<RealType>& d = dk;
+    d[0] = (xk[1] - xk[0])/(gk[1] - gk[0]);
+    d[n - 1] = (xk[n - 1] - xk[n - 2])/(gk[n - 1] - gk[n - 2]);
+    for (size_type k=1; k + 1<n; ++k) {
+        const RealType hl = gk[k] - gk[k - 1];
+        const RealType hr = gk[k + 1] - gk[k];
+        const RealType sl = (xk[k] - xk[k - 1])/hl;
+        const RealType sr = (xk[k + 1] - xk[k])/hr;
+        const RealType wl = 2*hr + hl;
+        const RealType wr = hr + 2*hl;
+        d[k] = (sl>RealType(0) && sr>RealType(0)) ?
+                   (wl + wr)/(wl/sl + wr/sr) : RealType(0);
+    }
+
+    // Choose abscissae that evenly split the count of sub-intervals.
+    size_type k = 0;
+    for (size_type j=1; j<m; ++j) {
+        RealType g = total*(static_cast<RealType>(j)/target);
+        while (k + 2<n && gk[k + 1]<g)
+            ++k;
+        const RealType h = gk[k + 1] - gk[k];
+        const RealType t = std::min(std::max((g - gk[k])/h, RealType(0)),
+                                    RealType(1));
+        const RealType t2 = t*t;
+        const RealType t3 = t2*t;
+        xp[j] = (2*t3 - 3*t2 + 1)*xk[k] + (t3 - 2*t2 + t)*h*d[k] +
+                (-2*t3 + 3*t2)*xk[k + 1] + (t3 - t2)*h*d[k + 1];
+    }
+
+    return xp;
+}
+
+
 /// A partition and the local function extrema over each sub-interval.
 ///
 /// Partition of an interval into sub-intervals [`x[i]`, `x[i+1]`].
@@ -149,57 +361,343 @@ struct partition_data
 };
 
 
-/// Computes an ETF partition using Newton's method.
-///
-/// A Newton's method (multivariate) is used to determine a partition of the
-/// interval defined by the first and last point of the vector of abcissae
-/// passed in argument in such a way that the rectangles making up an upper
-/// Riemann sum of function `f` have equal areas.
-///
-/// The returned `partition_data` object includes as well the infimum and
-/// supremum of the function over each sub-interval. 
+namespace detail {
+
+struct newton_solver;
+
+
+// Lifts the suprema of a partition so that all upper rectangles have the
+// same area, namely that of the largest one.
+template<typename RealType>
+void equalize_upper_areas(partition_data<RealType>& p) {
+    const std::size_t n = p.fsup.size();
+    RealType max_area = 0;
+    for (std::size_t i=0; i!=n; ++i)
+        max_area = std::max(max_area,
+                            p.fsup[i]*std::abs(p.x[i + 1] - p.x[i]));
+    for (std::size_t i=0; i!=n; ++i) {
+        RealType width = std::abs(p.x[i + 1] - p.x[i]);
+        if (width>RealType(0))
+            p.fsup[i] = std::max(p.fsup[i], max_area/width);
+    }
+}
+
+} // namespace detail
+
+
+/// Evaluation policy for the partition solvers: the function and its
+/// derivative are evaluated at each node in turn.
 ///
-/// For faster convergence it is recommended to provide a reasonable initial
-/// estimate of the partition abcissae passed in arguments.
+struct serial_evaluation {};
+
+
+/// Evaluation policy for the partition solvers: the nodes are split into
+/// contiguous ranges which are evaluated concurrently.
 ///
-/// The derivative `df` of `f` and an ordered sequence of the inner function
-/// extrema (boundary points excluded) must as well be provided.
+/// The function and its derivative must be safe to call concurrently. If
+/// `nb_threads` is 0, as many threads as there are hardware threads are used.
+/// Each range has at least `min_chunk_size` nodes so that threads are only
+/// started when there is enough work to share.
 ///
-/// The tolerance is the maximum relative dispersion of upper rectangle areas,
-/// computed as the difference between the largest and smallest area relative
-/// to the average area.
+struct parallel_evaluation
+{
+    explicit parallel_evaluation(unsigned int nb_threads = 0,
+                                 std::size_t min_chunk_size = 16)
+    : nb_threads(nb_threads), min_chunk_size(min_chunk_size) {}
+
+    unsigned int nb_threads;
+    std::size_t min_chunk_size;
+};
+
+
+/// Evaluation policy for the partition solvers: the function and its
+/// derivative are evaluated over arrays of nodes.
 ///
-/// Empty tables (with size 0) are returned if the algorithm fails to
-/// converge.
+/// The function and its derivative must then be callable as
+/// `f(const RealType* x, RealType* y, std::size_t n)` and assign `y[k]` with
+/// the value at `x[k]` for each `k` in [0, `n`), which makes it possible to
+/// use vectorized implementations.
 ///
-/// In order to improve convergence robustness (resp. speed), under-relaxation
-/// (resp. over-relaxation) may be optionaly mandated by setting `relax` at
-/// less (resp. more) than 1.
+struct batched_evaluation {};
+
+
+namespace detail {
+
+// Calls `body(first, last)` over contiguous sub-ranges of [0, `n`) using
+// several threads.
+template<class Body>
+void parallel_for(const parallel_evaluation& policy, std::size_t n,
+                  Body body) {
+    std::size_t nb_threads = policy.nb_threads;
+    if (nb_threads==0)
+        nb_threads = std::thread::hardware_concurrency();
+    std::size_t max_threads =
+        n/(policy.min_chunk_size!=0 ? policy.min_chunk_size : 1);
+    if (nb_threads>max_threads)
+        nb_threads = max_threads;
+    if (nb_threads<=1) {
+        body(std::size_t(0), n);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(nb_threads);
+    auto task = [&](std::size_t t) {
+        try {
+            body(n*t/nb_threads, n*(t + 1)/nb_threads);
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    std::size_t t = 1;
+    try {
+        for (; t!=nb_threads; ++t)
+            threads.emplace_back(task, t);
+    }
+    catch (const std::system_error&) {
+        // Carry on with the threads that could be started.
+    }
+
+    // The calling thread processes the first range and the ranges for which
+    // no thread could be started.
+    task(0);
+    for (; t!=nb_threads; ++t)
+        task(t);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+
+// Evaluates a function over an array of nodes.
+template<class Func, typename RealType>
+void evaluate(serial_evaluation, Func& f,
+              const RealType* x, RealType* y, std::size_t n) {
+    for (std::size_t k=0; k!=n; ++k)
+        y[k] = f(x[k]);
+}
+
+template<class Func, typename RealType>
+void evaluate(const parallel_evaluation& policy, Func& f,
+              const RealType* x, RealType* y, std::size_t n) {
+    parallel_for(policy, n, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k=first; k!=last; ++k)
+            y[k] = f(x[k]);
+    });
+}
+
+template<class Func, typename RealType>
+void evaluate(batched_evaluation, Func& f,
+              const RealType* x, RealType* y, std::size_t n) {
+    if (n!=0)
+        f(x, y, n);
+}
+
+
+// Evaluates a function and its derivative over an array of nodes.
+template<class Func, class DFunc, typename RealType>
+void evaluate(serial_evaluation, Func& f, DFunc& df,
+              const RealType* x, RealType* y, RealType* dy, std::size_t n) {
+    for (std::size_t k=0; k!=n; ++k)
+        evaluate_node(f, df, x[k], y[k], dy[k]);
+}
+
+template<class Func, class DFunc, typename RealType>
+void evaluate(const parallel_evaluation& policy, Func& f, DFunc& df,
+              const RealType* x, RealType* y, RealType* dy, std::size_t n) {
+    parallel_for(policy, n, [&](std::size_t first, std::size_t last) {
+        for (std::size_t k=first; k!=last; ++k)
+            evaluate_node(f, df, x[k], y[k], dy[k]);
+    });
+}
+
+template<class Func, class DFunc, typename RealType>
+void evaluate(batched_evaluation, Func& f, DFunc& df,
+              const RealType* x, RealType* y, RealType* dy, std::size_t n) {
+    if (n!=0) {
+        f(x, y, n);
+        df(x, dy, n);
+    }
+}
+
+// The shifted nodes of the finite difference and the dual numbers are
+// evaluated in chunks so as to avoid any allocation.
+template<class Func, typename RealType>
+void evaluate(batched_evaluation, Func& f,
+              finite_difference_derivative<RealType>& df,
+              const RealType* x, RealType* y, RealType* dy, std::size_t n) {
+    using std::abs;
+    if (n==0)
+        return;
+    f(x, y, n);
+    const std::size_t chunk_size = 64;
+    RealType xh[chunk_size];
+    RealType h[chunk_size];
+    for (std::size_t first=0; first<n; first+=chunk_size) {
+        std::size_t m = std::min(chunk_size, n - first);
+        for (std::size_t k=0; k!=m; ++k) {
+            RealType xk = x[first + k];
+            RealType hk = df.rel_step*(xk!=RealType(0) ? abs(xk)
+                                                       : RealType(1));
+            xh[k] = xk + hk;
+            h[k] = xh[k] - xk;
+        }
+        f(xh, dy + first, m);
+        for (std::size_t k=0; k!=m; ++k)
+            dy[first + k] = (dy[first + k] - y[first + k])/h[k];
+    }
+}
+
+template<class Func, typename RealType>
+void evaluate(batched_evaluation, Func& f, automatic_derivative&,
+              const RealType* x, RealType* y, RealType* dy, std::size_t n) {
+    const std::size_t chunk_size = 64;
+    dual<RealType> xd[chunk_size];
+    dual<RealType> yd[chunk_size];
+    for (std::size_t first=0; first<n; first+=chunk_size) {
+        std::size_t m = std::min(chunk_size, n - first);
+        for (std::size_t k=0; k!=m; ++k)
+            xd[k] = dual<RealType>(x[first + k], RealType(1));
+        f(static_cast<const dual<RealType>*>(xd), yd, m);
+        for (std::size_t k=0; k!=m; ++k) {
+            y[first + k] = yd[k].value();
+            dy[first + k] = yd[k].derivative();
+        }
+    }
+}
+
+} // namespace detail
+
+
+/// Reusable working storage for the partition solvers.
 ///
-/// The maximum number of iterations for the Newtow method may be optionally
-/// specified.
+/// The partition solvers allocate a dozen of temporary vectors on each call.
+/// When many partitions are computed in turn, a workspace can be passed
+/// instead to the solvers: it keeps its storage alive across calls, together
+/// with the last computed partition, so that no memory is allocated as long
+/// as the number of sub-intervals and extrema do not exceed those of former
+/// solves or of the capacity reserved at construction.
 ///
-template<class Func, class DFunc, class InputIt1, class InputIt2>
-#if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
-__attribute__ ((noinline))
-#endif
-auto
-newton_partition(Func f,
-                 DFunc df,
-                 InputIt1 x_initial_first,
-                 InputIt1 x_initial_last,
-                 InputIt2 x_extremum_first,
-                 InputIt2 x_extremum_last,
-                 typename std::iterator_traits<InputIt1>::value_type tol,
-                 typename std::iterator_traits<InputIt1>::value_type relax = 1,
-                 unsigned int max_iter = 100)
--> partition_data<typename std::iterator_traits<InputIt1>::value_type> {
+template<typename RealType>
+class partition_workspace
+{
+public:
+    partition_workspace() = default;
 
-    using RealType = typename std::iterator_traits<InputIt1>::value_type;
+    /// Reserves storage for partitions with up to `nb_intervals`
+    /// sub-intervals and `nb_extrema` inner extrema.
+    ///
+    explicit partition_workspace(std::size_t nb_intervals,
+                                 std::size_t nb_extrema = 0) {
+        reserve(nb_intervals, nb_extrema);
+    }
+
+    /// Reserves storage for partitions with up to `nb_intervals`
+    /// sub-intervals and `nb_extrema` inner extrema.
+    ///
+    void reserve(std::size_t nb_intervals, std::size_t nb_extrema = 0) {
+        const std::size_t n = nb_intervals;
+        const std::size_t m = n!=0 ? n - 1 : 0;
+        p_.x.reserve(n + 1);
+        p_.finf.reserve(n);
+        p_.fsup.reserve(n);
+        x_extrema_.reserve(nb_extrema);
+        f_extrema_.reserve(nb_extrema);
+        extrema_.reserve(nb_extrema);
+        y_.reserve(n + 1);
+        dx_.reserve(m);
+        dy_dx_.reserve(n + 1);
+        dfsup_dxl_.reserve(n);
+        dfsup_dxr_.reserve(n);
+        minus_s_.reserve(m);
+        ds_dxc_.reserve(m);
+        ds_dxl_.reserve(m);
+        ds_dxr_.reserve(m);
+    }
+
+    /// Returns the last computed partition.
+    ///
+    const partition_data<RealType>& partition() const {
+        return p_;
+    }
+
+private:
+    friend struct detail::newton_solver;
+
+    void resize(std::size_t n) {
+        y_.resize(n + 1);
+        dx_.resize(n - 1);
+        dy_dx_.resize(n + 1);
+        dfsup_dxl_.resize(n);
+        dfsup_dxr_.resize(n);
+        minus_s_.resize(n - 1);
+        ds_dxc_.resize(n - 1);
+        ds_dxl_.resize(n - 1);
+        ds_dxr_.resize(n - 1);
+    }
+
+    partition_data<RealType> p_;
+    std::vector<RealType> x_extrema_, f_extrema_;
+    std::vector<std::pair<RealType, RealType>> extrema_;
+    std::vector<RealType> y_, dx_, dy_dx_;
+    std::vector<RealType> dfsup_dxl_, dfsup_dxr_;
+    std::vector<RealType> minus_s_;
+    std::vector<RealType> ds_dxc_, ds_dxl_, ds_dxr_;
+};
+
+
+namespace detail {
+
+// Newton partition solver, using the storage of a workspace.
+struct newton_solver
+{
+    template<typename RealType, class Func, class DFunc,
+             class InputIt1, class InputIt2, class Evaluation>
+    static void solve(Func& f,
+                      DFunc& df,
+                      InputIt1 x_initial_first,
+                      InputIt1 x_initial_last,
+                      InputIt2 x_extremum_first,
+                      InputIt2 x_extremum_last,
+                      RealType tol,
+                      RealType relax,
+                      unsigned int max_iter,
+                      Evaluation& evaluation,
+                      partition_workspace<RealType>& workspace,
+                      partition_data<RealType>& p,
+                      bool keep_unconverged = false);
+
+    template<typename RealType>
+    static partition_data<RealType>&
+    partition(partition_workspace<RealType>& workspace) {
+        return workspace.p_;
+    }
+};
+
+
+template<typename RealType, class Func, class DFunc,
+         class InputIt1, class InputIt2, class Evaluation>
+void newton_solver::solve(Func& f,
+                          DFunc& df,
+                          InputIt1 x_initial_first,
+                          InputIt1 x_initial_last,
+                          InputIt2 x_extremum_first,
+                          InputIt2 x_extremum_last,
+                          RealType tol,
+                          RealType relax,
+                          unsigned int max_iter,
+                          Evaluation& evaluation,
+                          partition_workspace<RealType>& workspace,
+                          partition_data<RealType>& p,
+                          bool keep_unconverged) {
     using size_type = typename std::vector<RealType>::size_type;
 
-    // Partition object and convenient aliases.
-    partition_data<RealType> p;
+    // Convenient aliases.
     auto& x    = p.x;
     auto& finf = p.finf;
     auto& fsup = p.fsup;
@@ -210,25 +708,39 @@ newton_partition(Func f,
     finf.resize(n);
     fsup.resize(n);
     
-    std::vector<std::pair<RealType, RealType>> extrema;
+    auto& x_extrema = workspace.x_extrema_;
+    x_extrema.clear();
     while (x_extremum_first!=x_extremum_last) {
         if ((*x_extremum_first-x.front())*(*x_extremum_first-x.back())<=0.0) {
-            extrema.push_back(
-                std::pair<RealType, RealType>(*x_extremum_first, f(*x_extremum_first)) );
+            x_extrema.push_back(*x_extremum_first);
         }
         ++x_extremum_first;
     }
+    auto& f_extrema = workspace.f_extrema_;
+    f_extrema.resize(x_extrema.size());
+    detail::evaluate(evaluation, f,
+                     x_extrema.data(), f_extrema.data(), x_extrema.size());
+    auto& extrema = workspace.extrema_;
+    extrema.clear();
+    for (size_type i=0; i!=x_extrema.size(); ++i) {
+        extrema.push_back(
+            std::pair<RealType, RealType>(x_extrema[i], f_extrema[i]) );
+    }
     
     // define the main vectors and pre-compute edge values
-    std::vector<RealType> y(n+1);
-    std::vector<RealType> dx(n-1);
-    std::vector<RealType> dy_dx(n+1);
-    std::vector<RealType> dfsup_dxl(n), dfsup_dxr(n);
-    std::vector<RealType> minus_s(n-1);
-    std::vector<RealType> ds_dxc(n-1), ds_dxl(n-1), ds_dxr(n-1);
+    auto& y = workspace.y_;
+    auto& dx = workspace.dx_;
+    auto& dy_dx = workspace.dy_dx_;
+    auto& dfsup_dxl = workspace.dfsup_dxl_;
+    auto& dfsup_dxr = workspace.dfsup_dxr_;
+    auto& minus_s = workspace.minus_s_;
+    auto& ds_dxc = workspace.ds_dxc_;
+    auto& ds_dxl = workspace.ds_dxl_;
+    auto& ds_dxr = workspace.ds_dxr_;
+    workspace.resize(n);
     
-    y.front() = f(x.front());
-    y.back()  = f(x.back());
+    detail::evaluate(evaluation, f, &x.front(), &y.front(), 1);
+    detail::evaluate(evaluation, f, &x.back(), &y.back(), 1);
     dy_dx.front() = 0.0;
     dy_dx.back()  = 0.0;
     
@@ -236,10 +748,7 @@ newton_partition(Func f,
     while(true)
     {
         // Compute the values at inner points.
-        for (size_type i=1; i!=n; ++i) {
-            y[i] = f(x[i]);
-            dy_dx[i] = df(x[i]);
-        }
+        detail::evaluate(evaluation, f, df, &x[1], &y[1], &dy_dx[1], n - 1);
         
         // Determine the supremum fsup of y in the range (x[i], x[i+1]),
         // the partial derivatives of fsup with respect to x[i] and x[i+1],
@@ -278,8 +787,11 @@ newton_partition(Func f,
             sum_area += area;
         }
         
-        // Check convergence.
-        if ((max_area-min_area)<tol*(sum_area/n)) {
+        // Check convergence; unless the last iterate is to be kept, the
+        // infimum is only needed upon convergence.
+        bool converged = (max_area-min_area)<tol*(sum_area/n);
+        bool exhausted = !converged && ++iter>max_iter;
+        if (converged || (exhausted && keep_unconverged)) {
             // Determine the infimum finf of y in the range (x[i], x[i+1]).
             extremum = extrema.begin();
             for (size_type i=0; i!=n; ++i) {
@@ -303,7 +815,7 @@ newton_partition(Func f,
             break;
         }
         
-        if (++iter>max_iter) {
+        if (exhausted) {
             p.x.clear();
             p.finf.clear();
             p.fsup.clear();
@@ -335,7 +847,7 @@ newton_partition(Func f,
         //      | dx1     |         | minus_s0     |
         // dX = | ...     |    -S = | ...    |
         //      | dx(n-1) |         | minus_s(n-2) |
-        detail::solve_tridiagonal_system<RealType>(
+        detail::solve_tridiagonal_system(
             ds_dxl, ds_dxc, ds_dxr, minus_s, dx );
         
         // For the sake of stability, updated positions are constrained within
@@ -350,6 +862,73 @@ newton_partition(Func f,
             }
         }
     }
+}
+
+} // namespace detail
+
+
+/// Computes an ETF partition using Newton's method.
+///
+/// A Newton's method (multivariate) is used to determine a partition of the
+/// interval defined by the first and last point of the vector of abcissae
+/// passed in argument in such a way that the rectangles making up an upper
+/// Riemann sum of function `f` have equal areas.
+///
+/// The returned `partition_data` object includes as well the infimum and
+/// supremum of the function over each sub-interval. 
+///
+/// For faster convergence it is recommended to provide a reasonable initial
+/// estimate of the partition abcissae passed in arguments.
+///
+/// The derivative `df` of `f` and an ordered sequence of the inner function
+/// extrema (boundary points excluded) must as well be provided. In place of
+/// `df`, an `automatic_derivative` or `finite_difference_derivative` may be
+/// passed to have the derivative computed by the solver.
+///
+/// The tolerance is the maximum relative dispersion of upper rectangle areas,
+/// computed as the difference between the largest and smallest area relative
+/// to the average area.
+///
+/// Empty tables (with size 0) are returned if the algorithm fails to
+/// converge.
+///
+/// In order to improve convergence robustness (resp. speed), under-relaxation
+/// (resp. over-relaxation) may be optionaly mandated by setting `relax` at
+/// less (resp. more) than 1.
+///
+/// The maximum number of iterations for the Newtow method may be optionally
+/// specified.
+///
+/// The function and its derivative are evaluated at all inner nodes on each
+/// iteration; for expensive functions, a `parallel_evaluation` or
+/// `batched_evaluation` policy may be optionally specified to speed up these
+/// evaluations. Serial and parallel evaluations produce identical results.
+///
+template<class Func, class DFunc, class InputIt1, class InputIt2,
+         class Evaluation = serial_evaluation>
+#if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+__attribute__ ((noinline))
+#endif
+auto
+newton_partition(Func f,
+                 DFunc df,
+                 InputIt1 x_initial_first,
+                 InputIt1 x_initial_last,
+                 InputIt2 x_extremum_first,
+                 InputIt2 x_extremum_last,
+                 typename std::iterator_traits<InputIt1>::value_type tol,
+                 typename std::iterator_traits<InputIt1>::value_type relax = 1,
+                 unsigned int max_iter = 100,
+                 Evaluation evaluation = Evaluation())
+-> partition_data<typename std::iterator_traits<InputIt1>::value_type> {
+
+    using RealType = typename std::iterator_traits<InputIt1>::value_type;
+
+    partition_data<RealType> p;
+    partition_workspace<RealType> workspace;
+    detail::newton_solver::solve(f, df, x_initial_first, x_initial_last,
+        x_extremum_first, x_extremum_last, tol, relax, max_iter, evaluation,
+        workspace, p);
     
     // Voila.
     return p;
@@ -361,7 +940,8 @@ newton_partition(Func f,
 /// This overload can be used if the function is monotonic over the specified
 /// interval.
 ///
-template<class Func, class DFunc, class InputIt1>
+template<class Func, class DFunc, class InputIt1,
+         class Evaluation = serial_evaluation>
 #if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
 __attribute__ ((noinline))
 #endif
@@ -373,15 +953,501 @@ newton_partition_monotonic(
     InputIt1 x_initial_last,
     typename std::iterator_traits<InputIt1>::value_type tol,
     typename std::iterator_traits<InputIt1>::value_type relax = 1,
-    unsigned int max_iter = 100)
+    unsigned int max_iter = 100,
+    Evaluation evaluation = Evaluation())
 -> partition_data<typename std::iterator_traits<InputIt1>::value_type> {
     
     typename std::iterator_traits<InputIt1>::value_type* dummy_ptr = 0;
     return newton_partition(f, df, x_initial_first, x_initial_last,
-        dummy_ptr, dummy_ptr, tol, relax, max_iter);
+        dummy_ptr, dummy_ptr, tol, relax, max_iter, evaluation);
+}
+
+
+/// Computes an ETF partition using Newton's method and a workspace.
+///
+/// This overload computes the partition in the storage of the workspace
+/// passed as first argument and returns a reference to the partition held by
+/// the workspace, which remains valid until the next solve. No memory is
+/// allocated if the workspace is large enough.
+///
+template<class Func, class DFunc, class InputIt1, class InputIt2,
+         class Evaluation = serial_evaluation>
+#if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+__attribute__ ((noinline))
+#endif
+auto
+newton_partition(
+    partition_workspace<
+        typename std::iterator_traits<InputIt1>::value_type>& workspace,
+    Func f,
+    DFunc df,
+    InputIt1 x_initial_first,
+    InputIt1 x_initial_last,
+    InputIt2 x_extremum_first,
+    InputIt2 x_extremum_last,
+    typename std::iterator_traits<InputIt1>::value_type tol,
+    typename std::iterator_traits<InputIt1>::value_type relax = 1,
+    unsigned int max_iter = 100,
+    Evaluation evaluation = Evaluation())
+-> const partition_data<typename std::iterator_traits<InputIt1>::value_type>& {
+
+    auto& p = detail::newton_solver::partition(workspace);
+    detail::newton_solver::solve(f, df, x_initial_first, x_initial_last,
+        x_extremum_first, x_extremum_last, tol, relax, max_iter, evaluation,
+        workspace, p);
+
+    return p;
 }
 
 
+/// Computes an ETF partition using Newton's method and a workspace.
+///
+/// This overload can be used if the function is monotonic over the specified
+/// interval.
+///
+template<class Func, class DFunc, class InputIt1,
+         class Evaluation = serial_evaluation>
+#if defined(__clang__) || defined(__GNUC__) || defined(__GNUG__)
+__attribute__ ((noinline))
+#endif
+auto
+newton_partition_monotonic(
+    partition_workspace<
+        typename std::iterator_traits<InputIt1>::value_type>& workspace,
+    Func f,
+    DFunc df,
+    InputIt1 x_initial_first,
+    InputIt1 x_initial_last,
+    typename std::iterator_traits<InputIt1>::value_type tol,
+    typename std::iterator_traits<InputIt1>::value_type relax = 1,
+    unsigned int max_iter = 100,
+    Evaluation evaluation = Evaluation())
+-> const partition_data<typename std::iterator_traits<InputIt1>::value_type>& {
+    
+    typename std::iterator_traits<InputIt1>::value_type* dummy_ptr = 0;
+    return newton_partition(workspace, f, df, x_initial_first, x_initial_last,
+        dummy_ptr, dummy_ptr, tol, relax, max_iter, evaluation);
+}
+
+
+#if __cplusplus >= 201703L
+
+namespace detail {
+
+template<typename RealType>
+constexpr RealType static_abs(RealType x) {
+    return x<RealType(0) ? -x : x;
+}
+
+} // namespace detail
+
+
+/// Computes the exponential of a floating point number at compile time.
+///
+/// This is a `constexpr` substitute for `std::exp` intended for the
+/// evaluation of probability density functions at compile time. The result is
+/// typically within 1 ulp of `std::exp` for `float` and `double`.
+///
+/// Requires C++17.
+///
+template<typename RealType>
+constexpr RealType static_exp(RealType x) {
+    using limits = std::numeric_limits<RealType>;
+    constexpr long double ln2 = 0.693147180559945309417232121458176568L;
+
+    if (x!=x) return x;
+    if (x>limits::max_exponent*ln2)
+        return limits::has_infinity ? limits::infinity() : limits::max();
+    if (x<(limits::min_exponent - limits::digits)*ln2)
+        return RealType(0);
+    
+    // Range reduction x = k*ln(2) + r with |r| <= ln(2)/2, carried out in
+    // extended precision where available.
+    long double xl = x;
+    long k = static_cast<long>(xl/ln2 + (xl<0 ? -0.5L : 0.5L));
+    long double r = xl - k*ln2;
+    
+    // Taylor series of exp(r).
+    long double sum = 1;
+    long double term = 1;
+    for (int j=1; j!=40; ++j) {
+        term *= r/j;
+        if (sum + term==sum) break;
+        sum += term;
+    }
+    
+    // Scaling by 2^k.
+    for (; k>0; --k) sum *= 2;
+    for (; k<0; ++k) sum *= 0.5L;
+    
+    return static_cast<RealType>(sum);
+}
+
+
+/// A partition and the local function extrema over each sub-interval, with a
+/// number `M` of sub-intervals known at compile time.
+///
+/// This is the fixed-size counterpart of `partition_data`.
+///
+template<typename RealType, std::size_t M>
+struct static_partition_data
+{
+    std::array<RealType, M+1> x;
+    std::array<RealType, M> finf;
+    std::array<RealType, M> fsup;
+};
+
+
+/// Computes at compile time a partition dividing approximately evenly the
+/// area under a function using the trapezoidal rule.
+///
+/// This is the `constexpr` counterpart of `trapezoidal_rule_prepartition`,
+/// with the number `M` of sub-intervals and the number `P` of grid points
+/// specified as template parameters. Function `f` must be usable in constant
+/// expressions.
+///
+/// Requires C++17.
+///
+template<std::size_t M, std::size_t P = M, typename RealType, class Func>
+constexpr std::array<RealType, M+1>
+static_trapezoidal_rule_prepartition(Func f, RealType x0, RealType x1) {
+    using size_type = std::size_t;
+    
+    // Convenient const aliases.
+    constexpr size_type n = P;
+    constexpr size_type m = M;
+    
+    // Compute the curve.
+    RealType dx = (x1-x0)/(n-1);
+    std::array<RealType, n> x{};
+    std::array<RealType, n> y{};
+    for (size_type i=0; i!=(n-1); ++i) {
+        x[i] = x0 + i*dx;
+        y[i] = f(x[i]);
+    }
+    x[n-1] = x1;
+    y[n-1] = f(x1);
+    
+    // Total area (scaled by 1/dx).
+    RealType s = RealType(0.5)*(y[0] + y[n-1]);
+    for (size_type i=1; i!=(n-2); ++i) {
+        s += y[i];
+    }
+    
+    // Choose abscissae that evenly split the area under the curve.
+    std::array<RealType, m+1> xp{};
+    xp[0] = x0;
+    xp[m] = x1;   
+    {
+        RealType al = 0.0;
+        RealType ar = RealType(0.5)*(y[0] + y[1]);
+        size_type i=0;
+        for (size_type j=1; j!=m; ++j) {
+            RealType a = s*(static_cast<RealType>(j)/static_cast<RealType>(m));
+            while (a>ar) {
+                ++i;
+                al = ar;
+                ar += RealType(0.5)*(y[i] + y[i+1]);
+            }
+            xp[j] = x[i] + (x[i+1]-x[i])*((a-al)/(ar-al));
+        }
+    }
+    
+    return xp;
+}
+
+
+/// Computes at compile time an ETF partition using Newton's method.
+///
+/// This is the `constexpr` counterpart of `newton_partition`, with the inner
+/// function extrema passed as an array. Functions `f` and `df` must be usable
+/// in constant expressions.
+///
+/// Since the result cannot be empty, a `partition_convergence_error` is
+/// thrown if the algorithm fails to converge, which turns into a compilation
+/// error when the function is evaluated at compile time.
+///
+/// All work arrays are automatic variables: when evaluated at run time with
+/// a large number of sub-intervals, `newton_partition` should be preferred.
+///
+/// Requires C++17.
+///
+template<class Func, class DFunc, typename RealType, std::size_t K,
+         std::size_t E>
+constexpr static_partition_data<RealType, K-1>
+static_newton_partition(Func f,
+                        DFunc df,
+                        const std::array<RealType, K>& x_initial,
+                        const std::array<RealType, E>& x_extremum,
+                        RealType tol,
+                        RealType relax = 1,
+                        unsigned int max_iter = 100) {
+    using size_type = std::size_t;
+
+    // Partition object and convenient aliases.
+    static_partition_data<RealType, K-1> p{};
+    auto& x    = p.x;
+    auto& finf = p.finf;
+    auto& fsup = p.fsup;
+    constexpr size_type n = K-1;
+    
+    x = x_initial;
+    
+    std::array<RealType, E> extremum_x{};
+    std::array<RealType, E> extremum_f{};
+    size_type nb_extrema = 0;
+    for (size_type j=0; j!=E; ++j) {
+        if ((x_extremum[j]-x.front())*(x_extremum[j]-x.back())<=0.0) {
+            extremum_x[nb_extrema] = x_extremum[j];
+            extremum_f[nb_extrema] = f(x_extremum[j]);
+            ++nb_extrema;
+        }
+    }
+    
+    // define the main vectors and pre-compute edge values
+    std::array<RealType, n+1> y{};
+    std::array<RealType, n-1> dx{};
+    std::array<RealType, n+1> dy_dx{};
+    std::array<RealType, n> dfsup_dxl{}, dfsup_dxr{};
+    std::array<RealType, n-1> minus_s{};
+    std::array<RealType, n-1> ds_dxc{}, ds_dxl{}, ds_dxr{};
+    
+    y.front() = f(x.front());
+    y.back()  = f(x.back());
+    dy_dx.front() = 0.0;
+    dy_dx.back()  = 0.0;
+    
+    unsigned int iter = 0;
+    while(true)
+    {
+        // Compute the values at inner points.
+        for (size_type i=1; i!=n; ++i) {
+            y[i] = f(x[i]);
+            dy_dx[i] = df(x[i]);
+        }
+        
+        // Determine the supremum fsup of y in the range (x[i], x[i+1]),
+        // the partial derivatives of fsup with respect to x[i] and x[i+1],
+        // the minimum and maximum partition areas and the total area.
+        size_type extremum = 0;
+        RealType max_area = 0.0;
+        RealType min_area = std::numeric_limits<RealType>::max();
+        RealType sum_area = 0.0;
+        for (size_type i=0; i!=n; ++i) {
+            if (y[i]>y[i+1]) {
+                fsup[i] = y[i];
+                dfsup_dxl[i] = dy_dx[i];
+                dfsup_dxr[i] = 0.0;
+            }
+            else {
+                fsup[i] = y[i+1];
+                dfsup_dxl[i] = 0.0;
+                dfsup_dxr[i] = dy_dx[i+1];
+            }
+            
+            // Check if there are extrema within the (x[i], x[i+1]) range.
+            while ( extremum!=nb_extrema &&
+                    (extremum_x[extremum]-x[i])*(extremum_x[extremum]-x[i+1])
+                    <=0.0 )
+            {
+                if (extremum_f[extremum] > fsup[i]) {
+                    fsup[i] = extremum_f[extremum];
+                    dfsup_dxl[i] = 0.0;
+                    dfsup_dxr[i] = 0.0;
+                }
+                ++extremum;
+            }
+            
+            RealType area = fsup[i]*detail::static_abs(x[i+1]-x[i]);
+            max_area = std::max(area, max_area);
+            min_area = std::min(area, min_area);
+            sum_area += area;
+        }
+        
+        // Check convergence.
+        if ((max_area-min_area)<tol*(sum_area/n)) {
+            // Determine the infimum finf of y in the range (x[i], x[i+1]).
+            extremum = 0;
+            for (size_type i=0; i!=n; ++i) {
+                if (y[i]>y[i+1]) {
+                    finf[i] = y[i+1];
+                }
+                else {
+                    finf[i] = y[i];
+                }
+                
+                // Check if there are extrema within the (x[i], x[i+1]) range.
+                while (extremum!=nb_extrema &&
+                    (extremum_x[extremum]-x[i])*(extremum_x[extremum]-x[i+1])
+                    <=0.0 )
+                {
+                    if (extremum_f[extremum] < finf[i]) {
+                        finf[i] = extremum_f[extremum];
+                    }
+                    ++extremum;
+                }                
+            }
+            break;
+        }
+        
+        if (++iter>max_iter) {
+            throw partition_convergence_error();
+        }
+        
+        // Area difference between neigboring rectangles and partial
+        // derivatives of s with respect to x[i], x[i+1] and x[i+2].
+        for (size_type i=0; i!=(n-1); ++i) {
+            minus_s[i] = fsup[i]*(x[i+1]-x[i]) - fsup[i+1]*(x[i+2]-x[i+1]);
+            
+            ds_dxl[i] = fsup[i] - (x[i+1]-x[i])*dfsup_dxl[i];
+            ds_dxc[i] = (x[i+2]-x[i+1])*dfsup_dxl[i+1]
+                      - (x[i+1]-x[i])*dfsup_dxr[i]
+                      - (fsup[i] + fsup[i+1]);
+            ds_dxr[i] = fsup[i+1] + (x[i+2]-x[i+1])*dfsup_dxr[i+1];
+        }
+        
+        // Solve the tri-diagonal system S + (dS/dX)*dX = 0 (see
+        // `newton_partition`).
+        detail::solve_tridiagonal_system(
+            ds_dxl, ds_dxc, ds_dxr, minus_s, dx );
+        
+        // For the sake of stability, updated positions are constrained within
+        // the bounds set by former neighbors positions.
+        {
+            RealType x0 = x[0];
+            for (size_type i=1; i!=n; ++i) {
+                std::pair<RealType, RealType> x_range = std::minmax(x0, x[i+1]);
+                x0 = x[i];
+                x[i] = std::max(x[i] + relax*dx[i-1], x_range.first);
+                x[i] = std::min(x[i], x_range.second);
+            }
+        }
+    }
+    
+    // Voila.
+    return p;
+}
+
+
+/// Computes at compile time an ETF partition using Newton's method.
+///
+/// This overload can be used if the function is monotonic over the specified
+/// interval.
+///
+/// Requires C++17.
+///
+template<class Func, class DFunc, typename RealType, std::size_t K>
+constexpr static_partition_data<RealType, K-1>
+static_newton_partition_monotonic(
+    Func f,
+    DFunc df,
+    const std::array<RealType, K>& x_initial,
+    RealType tol,
+    RealType relax = 1,
+    unsigned int max_iter = 100) {
+    
+    return static_newton_partition(f, df, x_initial,
+        std::array<RealType, 0>{}, tol, relax, max_iter);
+}
+
+#endif // __cplusplus >= 201703L
+
+
+/// Tail of a normal distribution generated with Marsaglia's algorithm.
+///
+/// Generates the tail of a standard normal distribution such that:
+///
+///  `f(x) = s*exp(-x^2/2)` if `x > x0`
+///
+/// and otherwise:
+///
+///  `f(x) = 0`
+///
+/// where `x0` is strictly positive. The (positive) normalization constant `s`
+/// need not be specified.
+///
+/// Template parameter `W` sets the requested precision (in bits) for the
+/// generation of floating point random number.
+///
+template<typename RealType, std::size_t W>
+class normal_tail_distribution
+{
+public:
+    using result_type = RealType;
+    using param_type = normal_tail_distribution<RealType, W>;
+
+
+    normal_tail_distribution(RealType x0=1.0)
+    : x0_(x0), inv_x0_(RealType(1.0)/x0)
+    {}
+
+
+    /// Returns a random variate using the random number generator passed as
+    /// argument.
+    ///
+    /// This method is thread-safe as long as non-const methods are not used.
+    template<class RngType>
+    result_type operator()(RngType& g) const {
+        RealType dx;
+        RealType y;
+        do {
+            dx = std::log(RealType(1.0) - generate_random_real<RealType, W>(g))
+                 *inv_x0_;
+            y = std::log(RealType(1.0) - generate_random_real<RealType, W>(g));
+        } while (-2*y < dx*dx);
+        return x0_ - dx;
+    }
+
+
+    /// Resets the distribution.
+    ///
+    /// This method is a no-op; it is defined for the sake of compatibility with
+    /// distributions of the standard library.
+    void reset() {}
+
+
+    /// Returns an object containing the distribution parameters.
+    ///
+    param_type param() const {
+        return *this;
+    }
+
+
+    /// Initializes the distribution with new distribution parameters.
+    ///
+    void param(const param_type& params)
+    {
+        *this = params;
+    }
+
+    /// Returns the smallest value potentially returned by `operator()`.
+    result_type min() const {
+        return x0_;
+    }
+
+
+    /// Returns the greatest value potentially returned by `operator()`.
+    result_type max() const {
+        return std::numeric_limits<RealType>::is_iec559 ?
+                   std::numeric_limits<RealType>::infinity()
+                 : std::numeric_limits<RealType>::max();
+    }
+
+
+    /// Returns distribution parameter `x0`.
+    result_type x0() const {
+        return x0_;
+    }
+
+
+private:
+    RealType x0_;
+    RealType inv_x0_;
+};
+
+
+
+
 /// Tail of a 3-parameter Weibull distribution generated by inversion sampling.
 ///
 /// Generates the tail of a shifted Weibull distribution such that:
@@ -0,0 +1,287 @@
+#ifndef ETF_XOSHIRO_HPP
+#define ETF_XOSHIRO_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+/// Exclusive Top Floor namespace.
+///
+namespace etf {
+
+/// xoshiro256++ random number generator with L interleaved streams.
+///
+/// This is the 64-bit generator of Blackman and Vigna, which produces all 64
+/// bits of each output in a handful of bitwise operations and is thus well
+/// matched to the ETF algorithm's consumption of W=64 random bits per sample.
+///
+/// With L=1 the output sequence is that of the reference implementation. With
+/// L>1 the generator maintains L independent states, each one 2^128 steps
+/// ahead of the previous one, and outputs the states in round-robin order;
+/// the state updates are then independent across lanes and vectorize on
+/// SIMD-capable hardware.
+///
+/// In addition to the uniform random bit generator interface, a block output
+/// `fill()` is provided which is used directly by the bulk generation
+/// functions of the library.
+///
+template<std::size_t L>
+class basic_xoshiro256pp
+{
+    static_assert(L>=1, "the number of streams must be at least 1");
+
+public:
+    using result_type = std::uint64_t;
+
+    /// Number of interleaved streams.
+    static constexpr std::size_t lanes = L;
+
+    /// Seed used by the default constructor.
+    static constexpr result_type default_seed = 0x853c49e6748fea9bULL;
+
+
+    /// Constructs the generator with the default seed.
+    ///
+    basic_xoshiro256pp() {
+        seed(default_seed);
+    }
+
+
+    /// Constructs the generator with the specified seed.
+    ///
+    explicit basic_xoshiro256pp(result_type value) {
+        seed(value);
+    }
+
+
+    /// Reinitializes the state of the generator with the specified seed.
+    ///
+    /// The state is initialized with the output of a SplitMix64 generator, as
+    /// recommended by the authors of xoshiro256++.
+    ///
+    void seed(result_type value = default_seed) {
+        std::uint64_t t[4];
+        for (auto& w : t) {
+            value += 0x9e3779b97f4a7c15ULL;
+            std::uint64_t z = value;
+            z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+            w = z ^ (z >> 31);
+        }
+        for (std::size_t l=0; l!=L; ++l) {
+            for (std::size_t j=0; j!=4; ++j)
+                s_[j][l] = t[j];
+            jump_state(t, jump_poly());
+        }
+        pos_ = L;
+    }
+
+
+    /// Returns the smallest value potentially returned by `operator()`.
+    ///
+    static constexpr result_type min() {
+        return 0;
+    }
+
+
+    /// Returns the greatest value potentially returned by `operator()`.
+    ///
+    static constexpr result_type max() {
+        return ~result_type(0);
+    }
+
+
+    /// Returns a random number.
+    ///
+    result_type operator()() {
+        if (L==1) {
+            result_type x;
+            next(s_, &x);
+            return x;
+        }
+        if (pos_==L) {
+            next(s_, buf_);
+            pos_ = 0;
+        }
+        return buf_[pos_++];
+    }
+
+
+    /// Writes `n` random numbers to the specified array.
+    ///
+    /// The output is identical to that of `n` successive calls to
+    /// `operator()`.
+    ///
+    void fill(std::uint64_t* first, std::size_t n) {
+        for (; pos_!=L && n!=0; --n)
+            *first++ = buf_[pos_++];
+
+        // Work on a local copy of the state so that it can stay in registers.
+        std::uint64_t s[4][L];
+        copy_state(s_, s);
+        for (; n>=L; n -= L, first += L)
+            next(s, first);
+        if (n!=0) {
+            next(s, buf_);
+            for (pos_=0; pos_!=n; ++pos_)
+                *first++ = buf_[pos_];
+        }
+        copy_state(s, s_);
+    }
+
+
+    /// Advances the state by the specified number of steps.
+    ///
+    void discard(unsigned long long z) {
+        for (; z!=0; --z)
+            (*this)();
+    }
+
+
+    /// Advances each stream by L*2^128 steps.
+    ///
+    /// Successive jumps generate non-overlapping sub-sequences suitable for
+    /// parallel computations. Pending buffered outputs are discarded.
+    ///
+    void jump() {
+        jump_streams(jump_poly());
+    }
+
+
+    /// Advances each stream by L*2^192 steps.
+    ///
+    /// Pending buffered outputs are discarded.
+    ///
+    void long_jump() {
+        jump_streams(long_jump_poly());
+    }
+
+
+    friend bool operator==(const basic_xoshiro256pp& a,
+                           const basic_xoshiro256pp& b) {
+        for (std::size_t j=0; j!=4; ++j)
+            for (std::size_t l=0; l!=L; ++l)
+                if (a.s_[j][l]!=b.s_[j][l]) return false;
+        if (a.pos_!=b.pos_) return false;
+        for (std::size_t l=a.pos_; l!=L; ++l)
+            if (a.buf_[l]!=b.buf_[l]) return false;
+        return true;
+    }
+
+
+    friend bool operator!=(const basic_xoshiro256pp& a,
+                           const basic_xoshiro256pp& b) {
+        return !(a==b);
+    }
+
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+
+    // Computes the next output of each stream and advances the state.
+    static void next(std::uint64_t (&s)[4][L], std::uint64_t* out) {
+        for (std::size_t l=0; l!=L; ++l) {
+            out[l] = rotl(s[0][l] + s[3][l], 23) + s[0][l];
+            std::uint64_t t = s[1][l] << 17;
+            s[2][l] ^= s[0][l];
+            s[3][l] ^= s[1][l];
+            s[1][l] ^= s[2][l];
+            s[0][l] ^= s[3][l];
+            s[2][l] ^= t;
+            s[3][l] = rotl(s[3][l], 45);
+        }
+    }
+
+
+    static void copy_state(const std::uint64_t (&from)[4][L],
+                           std::uint64_t (&to)[4][L]) {
+        for (std::size_t j=0; j!=4; ++j)
+            for (std::size_t l=0; l!=L; ++l)
+                to[j][l] = from[j][l];
+    }
+
+
+    static const std::uint64_t* jump_poly() {
+        static constexpr std::uint64_t poly[4] =
+            { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+              0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        return poly;
+    }
+
+
+    static const std::uint64_t* long_jump_poly() {
+        static constexpr std::uint64_t poly[4] =
+            { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+              0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+        return poly;
+    }
+
+
+    // Applies a jump polynomial to a single-stream state.
+    static void jump_state(std::uint64_t (&t)[4], const std::uint64_t* poly) {
+        std::uint64_t j[4] = {0, 0, 0, 0};
+        for (std::size_t i=0; i!=4; ++i) {
+            for (int b=0; b!=64; ++b) {
+                if (poly[i] & (std::uint64_t(1) << b)) {
+                    for (std::size_t k=0; k!=4; ++k)
+                        j[k] ^= t[k];
+                }
+                std::uint64_t u = t[1] << 17;
+                t[2] ^= t[0];
+                t[3] ^= t[1];
+                t[1] ^= t[2];
+                t[0] ^= t[3];
+                t[2] ^= u;
+                t[3] = rotl(t[3], 45);
+            }
+        }
+        for (std::size_t k=0; k!=4; ++k)
+            t[k] = j[k];
+    }
+
+
+    // Applies L times a jump polynomial to each stream.
+    void jump_streams(const std::uint64_t* poly) {
+        for (std::size_t l=0; l!=L; ++l) {
+            std::uint64_t t[4];
+            for (std::size_t j=0; j!=4; ++j)
+                t[j] = s_[j][l];
+            for (std::size_t k=0; k!=L; ++k)
+                jump_state(t, poly);
+            for (std::size_t j=0; j!=4; ++j)
+                s_[j][l] = t[j];
+        }
+        pos_ = L;
+    }
+
+
+    std::uint64_t s_[4][L];
+    std::uint64_t buf_[L] = {};
+    std::size_t pos_;
+};
+
+template<std::size_t L>
+constexpr std::size_t basic_xoshiro256pp<L>::lanes;
+
+template<std::size_t L>
+constexpr typename basic_xoshiro256pp<L>::result_type
+basic_xoshiro256pp<L>::default_seed;
+
+
+/// Reference xoshiro256++ generator.
+///
+using xoshiro256pp = basic_xoshiro256pp<1>;
+
+
+/// xoshiro256++ generator with 4 interleaved streams.
+///
+/// The state update vectorizes with 256-bit SIMD registers.
+///
+using xoshiro256pp_x4 = basic_xoshiro256pp<4>;
+
+} // namespace etf
+
+#endif // ETF_XOSHIRO_HPP
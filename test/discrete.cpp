@@ -0,0 +1,64 @@
+// Checks the frequencies of discrete distributions over values of a type
+// narrower than `int`, starting at a negative value.
+//
+// Build with e.g.: g++ -std=c++11 -O2 -I.. discrete.cpp
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include <etf/discrete.hpp>
+
+namespace {
+
+// Returns true if the frequencies of the values of `d` match the
+// probabilities proportional to `p` within 5 standard deviations.
+template<typename IntType, class Dist>
+bool check_frequencies(const char* name, Dist& d, IntType k_first,
+                       const double* p, int nb_values) {
+    const long n = 10000000;
+    long counts[16] = {};
+    long outside = 0;
+    std::mt19937_64 rng(7);
+    for (long i=0; i!=n; ++i) {
+        int j = static_cast<int>(d(rng)) - static_cast<int>(k_first);
+        if (j>=0 && j<nb_values)
+            ++counts[j];
+        else
+            ++outside;
+    }
+    double total = 0;
+    for (int j=0; j!=nb_values; ++j)
+        total += p[j];
+    bool ok = outside==0;
+    for (int j=0; j!=nb_values; ++j) {
+        double q = p[j]/total;
+        double z = (static_cast<double>(counts[j])/n - q)
+                 / std::sqrt(q*(1.0 - q)/n);
+        ok &= std::abs(z)<5.0;
+    }
+    std::printf("%-28s %s\n", name, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // namespace
+
+
+int main() {
+    const double p[] = {1.0, 2.0, 3.0, 2.0, 1.0};
+    bool ok = true;
+
+    auto ds = etf::make_discrete_distribution<short, 32, 2>(
+        short(-2), p, p + 5);
+    ok &= check_frequencies("short, first value -2", ds, short(-2), p, 5);
+
+    auto dc = etf::make_discrete_distribution<signed char, 32, 2>(
+        static_cast<signed char>(-3), p, p + 5);
+    ok &= check_frequencies("signed char, first value -3", dc,
+                            static_cast<signed char>(-3), p, 5);
+
+    auto di = etf::make_discrete_distribution<int, 32, 2>(-2, p, p + 5);
+    ok &= check_frequencies("int, first value -2", di, -2, p, 5);
+
+    return ok ? 0 : 1;
+}
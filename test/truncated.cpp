@@ -0,0 +1,63 @@
+// Checks the tail mass of truncated views whose out-of-table portions are
+// sampled with a rectangle envelope on one side and with the outer
+// distribution on the other side.
+//
+// Build with e.g.: g++ -std=c++11 -O2 -I.. truncated.cpp
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+#include <etf/normal.hpp>
+#include <etf/truncated.hpp>
+
+namespace {
+
+double normal_cdf(double x) {
+    return 0.5*std::erfc(-x/std::sqrt(2.0));
+}
+
+// Returns true if the frequency of variates of `t` in [lo, hi] matches the
+// probability `p` within 5 standard deviations.
+template<class Truncated>
+bool check_mass(const char* name, const Truncated& t, double lo, double hi,
+                double p) {
+    const long n = 20000000;
+    std::mt19937_64 rng(42);
+    long hits = 0;
+    for (long i=0; i!=n; ++i) {
+        double x = t(rng);
+        hits += (x>=lo && x<=hi) ? 1 : 0;
+    }
+    double freq = static_cast<double>(hits)/n;
+    double z = (freq - p)/std::sqrt(p*(1.0 - p)/n);
+    bool ok = std::abs(z)<5.0;
+    std::printf("%-32s P=%.4e expected %.4e z=%6.2f %s\n",
+                name, freq, p, z, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // namespace
+
+
+int main() {
+    const auto& d = etf::detail::standard_normal_tables<double, 64, 8>();
+    const double inf = std::numeric_limits<double>::infinity();
+    bool ok = true;
+
+    // Left portion from the outer distribution, right one from a rectangle.
+    auto t1 = etf::make_truncated_distribution(d, -inf, 3.5);
+    double p1 = (normal_cdf(3.5) - normal_cdf(3.3))/normal_cdf(3.5);
+    ok &= check_mass("[-inf, 3.5], x in [3.3, 3.5]", t1, 3.3, 3.5, p1);
+    ok &= check_mass("[-inf, 3.5], x in [-inf, -3.3]", t1, -inf, -3.3,
+                     normal_cdf(-3.3)/normal_cdf(3.5));
+
+    // Mirror image.
+    auto t2 = etf::make_truncated_distribution(d, -3.5, inf);
+    ok &= check_mass("[-3.5, inf], x in [-3.5, -3.3]", t2, -3.5, -3.3, p1);
+    ok &= check_mass("[-3.5, inf], x in [3.3, inf]", t2, 3.3, inf,
+                     normal_cdf(-3.3)/normal_cdf(3.5));
+
+    return ok ? 0 : 1;
+}